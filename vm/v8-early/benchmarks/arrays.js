@@ -0,0 +1,72 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Array creation, push and pop, indexed loads and stores, join, slice,
+// concat, reverse and sort.
+
+function FillAndSum(size) {
+  var a = [];
+  for (var i = 0; i < size; i++) a.push(i * 3 & 1023);
+  var sum = 0;
+  for (var i = 0; i < a.length; i++) sum += a[i];
+  while (a.length > size / 2) sum -= a.pop();
+  return sum;
+}
+
+
+function PreallocatedStores(size) {
+  var a = new Array(size);
+  for (var i = 0; i < size; i++) a[i] = size - i;
+  var sum = 0;
+  for (var i = 1; i < size; i++) sum += a[i] - a[i - 1];
+  return sum;
+}
+
+
+function Builtins(size) {
+  var a = [];
+  for (var i = 0; i < size; i++) a[i] = (i * 7919) % size;
+  var b = a.slice(0, size / 2).concat(a.slice(size / 2));
+  b.reverse();
+  b.sort(function(x, y) { return x - y; });
+  return b[0] + b[size - 1] + b.join(',').length;
+}
+
+
+function RunArrays() {
+  var checksum = 0;
+  for (var n = 0; n < 100; n++) {
+    checksum += FillAndSum(2000);
+    checksum += PreallocatedStores(2000);
+    checksum += Builtins(500);
+  }
+  return checksum;
+}
+
+
+var result = RunArrays();
+if (result != 50048900) throw new Error('arrays: wrong result ' + result);
@@ -0,0 +1,83 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Function calls: closures capturing outer variables, recursion,
+// method calls, calls through call and apply, and the arguments
+// object.
+
+function MakeCounter(step) {
+  var count = 0;
+  return function() {
+    count += step;
+    return count;
+  };
+}
+
+
+function Fibonacci(n) {
+  return n < 2 ? n : Fibonacci(n - 1) + Fibonacci(n - 2);
+}
+
+
+function Sum() {
+  var sum = 0;
+  for (var i = 0; i < arguments.length; i++) sum += arguments[i];
+  return sum;
+}
+
+
+function Compose(f, g) {
+  return function(x) { return f(g(x)); };
+}
+
+
+function RunClosures() {
+  var checksum = 0;
+  var counters = [];
+  for (var i = 0; i < 10; i++) counters.push(MakeCounter(i));
+  var inc = function(x) { return x + 1; };
+  var twice = function(x) { return x * 2; };
+  var composed = Compose(inc, Compose(twice, inc));
+  var receiver = { base: 3, add: function(x) { return this.base + x; } };
+
+  for (var n = 0; n < 50; n++) {
+    for (var i = 0; i < 1000; i++) {
+      checksum += counters[i % 10]() & 0xff;
+      checksum += composed(i) & 0xff;
+      checksum += receiver.add.call(receiver, i & 7);
+    }
+    checksum += Fibonacci(18);
+    for (var i = 0; i < 200; i++) {
+      checksum += Sum(i, 1, 2, 3) + Sum.apply(null, [i, 4, 5]);
+    }
+  }
+  return checksum;
+}
+
+
+var result = RunClosures();
+if (result != 14570956) throw new Error('closures: wrong result ' + result);
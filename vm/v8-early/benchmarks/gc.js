@@ -0,0 +1,73 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Allocation of short-lived objects, arrays and strings, with a
+// smaller set of objects surviving into old space, to exercise
+// scavenges and mark-compact collections.
+
+function Node(value, next) {
+  this.value = value;
+  this.next = next;
+}
+
+
+function ShortLived(count) {
+  var sum = 0;
+  for (var i = 0; i < count; i++) {
+    var list = null;
+    for (var j = 0; j < 10; j++) list = new Node(j, list);
+    var a = [list.value, i, 'x' + i];
+    sum += a[0] + a[2].length;
+  }
+  return sum;
+}
+
+
+function LongLived(count, keep) {
+  var table = [];
+  var sum = 0;
+  for (var i = 0; i < count; i++) {
+    table[i % keep] = { id: i, name: 'node' + i, children: [i, i + 1] };
+    sum += table[i % keep].children.length;
+  }
+  for (var i = 0; i < keep; i++) sum += table[i].id & 1;
+  return sum;
+}
+
+
+function RunGC() {
+  var checksum = 0;
+  for (var n = 0; n < 10; n++) {
+    checksum += ShortLived(10000);
+    checksum += LongLived(20000, 5000);
+  }
+  return checksum;
+}
+
+
+var result = RunGC();
+if (result != 1813900) throw new Error('gc: wrong result ' + result);
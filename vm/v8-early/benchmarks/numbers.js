@@ -0,0 +1,68 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Number to string conversion in the formats used when rendering
+// output, and parsing numbers back.
+
+function Format(count) {
+  var length = 0;
+  for (var i = 0; i < count; i++) {
+    var value = i * 1.25 + 0.5;
+    length += String(i).length;
+    length += value.toString().length;
+    length += value.toFixed(2).length;
+    length += i.toString(16).length;
+    length += (value * 1e6).toExponential(3).length;
+    length += ('' + (i / 7)).length;
+  }
+  return length;
+}
+
+
+function Parse(count) {
+  var sum = 0;
+  for (var i = 0; i < count; i++) {
+    sum += parseInt('' + i, 10);
+    sum += parseFloat(i + '.5') * 2;
+    sum += Number('0x' + (i & 255).toString(16));
+  }
+  return sum;
+}
+
+
+function RunNumbers() {
+  var checksum = 0;
+  for (var n = 0; n < 20; n++) {
+    checksum += Format(1000);
+    checksum += Parse(1000);
+  }
+  return checksum;
+}
+
+
+var result = RunNumbers();
+if (result != 33289700) throw new Error('numbers: wrong result ' + result);
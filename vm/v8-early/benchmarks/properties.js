@@ -0,0 +1,100 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Property loads and stores through monomorphic and polymorphic inline
+// caches, prototype chain lookups and keyed access with symbol keys.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+Point.prototype.lengthSquared = function() {
+  return this.x * this.x + this.y * this.y;
+};
+
+
+function Point3D(x, y, z) {
+  this.x = x;
+  this.y = y;
+  this.z = z;
+}
+
+Point3D.prototype = new Point(0, 0);
+
+
+function MonomorphicAccess(points) {
+  var sum = 0;
+  for (var i = 0; i < points.length; i++) {
+    var p = points[i];
+    p.x = p.x + 1;
+    sum += p.x + p.y;
+  }
+  return sum;
+}
+
+
+function PolymorphicAccess(points) {
+  var sum = 0;
+  for (var i = 0; i < points.length; i++) {
+    sum += points[i].lengthSquared();
+  }
+  return sum;
+}
+
+
+function KeyedAccess(object, keys) {
+  var sum = 0;
+  for (var i = 0; i < keys.length; i++) {
+    sum += object[keys[i]];
+  }
+  return sum;
+}
+
+
+function RunProperties() {
+  var points = [];
+  var mixed = [];
+  for (var i = 0; i < 1000; i++) {
+    points.push(new Point(i, i & 7));
+    mixed.push((i & 1) ? new Point(i & 15, 1) : new Point3D(1, i & 15, 2));
+  }
+  var object = { alpha: 1, beta: 2, gamma: 3, delta: 4, epsilon: 5 };
+  var keys = ['alpha', 'beta', 'gamma', 'delta', 'epsilon'];
+
+  var checksum = 0;
+  for (var n = 0; n < 200; n++) {
+    checksum += MonomorphicAccess(points) & 0xffff;
+    checksum += PolymorphicAccess(mixed);
+    for (var k = 0; k < 40; k++) checksum += KeyedAccess(object, keys);
+  }
+  return checksum;
+}
+
+
+var result = RunProperties();
+if (result != 22325824) throw new Error('properties: wrong result ' + result);
@@ -0,0 +1,79 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Regular expression matching: test, exec with captures, global
+// replace and split.
+
+var kLog = [];
+for (var i = 0; i < 200; i++) {
+  kLog.push('2008-09-' + (10 + i % 20) + ' 12:' + (10 + i % 50) +
+            ' GET /index' + i + '.html 200 ' + (i * 37 % 5000));
+}
+var kLogText = kLog.join('\n');
+
+
+function TestLines(lines) {
+  var re = /GET \/index\d+\.html 200/;
+  var count = 0;
+  for (var i = 0; i < lines.length; i++) {
+    if (re.test(lines[i])) count++;
+  }
+  return count;
+}
+
+
+function ExecCaptures(lines) {
+  var re = /^(\d+)-(\d+)-(\d+) (\d+):(\d+) (\w+) (\S+) (\d+) (\d+)$/;
+  var sum = 0;
+  for (var i = 0; i < lines.length; i++) {
+    var match = re.exec(lines[i]);
+    if (match) sum += parseInt(match[9], 10) + match[7].length;
+  }
+  return sum;
+}
+
+
+function ReplaceAndSplit(text) {
+  var replaced = text.replace(/\d+/g, '#');
+  var fields = replaced.split(/\s+/);
+  return replaced.length + fields.length;
+}
+
+
+function RunRegExp() {
+  var checksum = 0;
+  for (var n = 0; n < 20; n++) {
+    checksum += TestLines(kLog);
+    checksum += ExecCaptures(kLog);
+    checksum += ReplaceAndSplit(kLogText);
+  }
+  return checksum;
+}
+
+
+var result = RunRegExp();
+if (result != 8531780) throw new Error('regexp: wrong result ' + result);
@@ -0,0 +1,89 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// String concatenation, character access, searching, splitting and
+// case conversion.
+
+var kText = 'The quick brown fox jumps over the lazy dog. ' +
+            'Pack my box with five dozen liquor jugs. ';
+
+
+function Concatenate(count) {
+  var s = '';
+  for (var i = 0; i < count; i++) s += 'item' + i + ';';
+  return s.length;
+}
+
+
+function CharCodes(text) {
+  var sum = 0;
+  for (var i = 0; i < text.length; i++) sum += text.charCodeAt(i);
+  return sum;
+}
+
+
+function Search(text, words) {
+  var found = 0;
+  for (var i = 0; i < words.length; i++) {
+    var position = text.indexOf(words[i]);
+    while (position >= 0) {
+      found++;
+      position = text.indexOf(words[i], position + 1);
+    }
+    found += text.lastIndexOf(words[i]) > 0 ? 1 : 0;
+  }
+  return found;
+}
+
+
+function SplitAndCase(text) {
+  var parts = text.split(' ');
+  var length = 0;
+  for (var i = 0; i < parts.length; i++) {
+    length += parts[i].toUpperCase().length + parts[i].substring(1).length;
+  }
+  return length;
+}
+
+
+function RunStrings() {
+  var text = '';
+  for (var i = 0; i < 50; i++) text += kText;
+  var words = ['fox', 'dog', 'jugs', 'quick brown', 'zebra', 'e'];
+  var checksum = 0;
+  for (var n = 0; n < 50; n++) {
+    checksum += Concatenate(1000);
+    checksum += CharCodes(text) & 0xffff;
+    checksum += Search(text, words);
+    checksum += SplitAndCase(text);
+  }
+  return checksum;
+}
+
+
+var result = RunStrings();
+if (result != 813950) throw new Error('strings: wrong result ' + result);
@@ -445,15 +445,65 @@ class Data {
  * data can be calculated for a script in advance of actually
  * compiling it, and stored between compilations.  When script data
  * is given to the compile method compilation will be faster.
+ *
+ * Script data pre-compiled from a source string is bound to that
+ * source and is ignored when compiling any other source.
+ *
+ * To store script data, write out the Length() words at Data().  The
+ * bytes can be turned back into script data with New.  The data is
+ * versioned and checksummed; data that is corrupt or was produced by a
+ * different version of V8 is ignored by the compiler.
  */
 class ScriptData {
  public:
   virtual ~ScriptData() { }
   static ScriptData* PreCompile(const char* input, int length);
+
+  /**
+   * Pre-compiles the source string.  The result is bound to the
+   * source.
+   */
+  static ScriptData* PreCompile(Handle<String> source);
   static ScriptData* New(unsigned* data, int length);
 
+  /**
+   * Creates script data from a copy of the given bytes, as previously
+   * written out from Data().
+   */
+  static ScriptData* New(const char* data, int length);
+
   virtual int Length() = 0;
   virtual unsigned* Data() = 0;
+
+  /**
+   * Returns true if a compilation ignored the data because it was
+   * corrupt, produced by a different version of V8 or for another
+   * source.
+   */
+  virtual bool Rejected() = 0;
+};
+
+
+/**
+ * Pre-compiles a script on a background thread.  The source is copied
+ * when the task is started and the thread does not enter V8, so the
+ * V8 thread can do other work in the meantime.  The script data
+ * returned by Finish is passed to Script::Compile to complete the
+ * compilation on the V8 thread; it is bound to the source like the
+ * result of ScriptData::PreCompile for a source string.
+ */
+class PreCompileTask {
+ public:
+  virtual ~PreCompileTask() { }
+
+  /** Starts pre-compiling the source on a new thread. */
+  static PreCompileTask* Start(Handle<String> source);
+
+  /**
+   * Waits for the thread to finish and returns the script data, owned
+   * by the caller, or NULL if pre-compiling failed.
+   */
+  virtual ScriptData* Finish() = 0;
 };
 
 
@@ -483,7 +533,6 @@ class ScriptOrigin {
  */
 class Script {
  public:
-
   /**
    * Compiles the specified script. The ScriptOrigin* and ScriptData*
    * parameters are owned by the caller of Script::Compile. No
@@ -1677,6 +1726,23 @@ class V8 {
    */
   static void AddObjectToGroup(void* id, Persistent<Object> obj);
 
+  /**
+   * Notifies V8 that the embedder is idle so that it can reduce its memory
+   * footprint: the heap is compacted, unused pages are returned to the OS
+   * and the young generation is shrunk.  Returns true if there was nothing
+   * left to reduce, in which case the embedder need not call it again until
+   * it has run more scripts.
+   */
+  static bool IdleNotification();
+
+  /**
+   * Prints the inline cache statistics collected when running with
+   * --ic-stats, one comma separated record per line: the state history
+   * and number of receiver maps of each inline cache site, followed by
+   * the fan-out of the hidden class (map) transition tree.
+   */
+  static void PrintICStatistics(FILE* out);
+
   /**
    * Initializes from snapshot if possible. Otherwise, attempts to initialize
    * from scratch.
@@ -33,6 +33,7 @@
 #include "debug.h"
 #include "execution.h"
 #include "global-handles.h"
+#include "ic-inl.h"
 #include "platform.h"
 #include "serialize.h"
 #include "snapshot.h"
@@ -996,11 +997,38 @@ ScriptData* ScriptData::PreCompile(const char* input, int length) {
 }
 
 
+ScriptData* ScriptData::PreCompile(v8::Handle<String> source) {
+  return i::PreParse(Utils::OpenHandle(*source), NULL);
+}
+
+
 ScriptData* ScriptData::New(unsigned* data, int length) {
   return new i::ScriptDataImpl(i::Vector<unsigned>(data, length));
 }
 
 
+ScriptData* ScriptData::New(const char* data, int length) {
+  // Copy the data to word aligned storage.  A partial word cannot be
+  // valid data, so leave the result empty to have it rejected.
+  int words = 0;
+  if (length % sizeof(unsigned) == 0) words = length / sizeof(unsigned);
+  unsigned* store = i::NewArray<unsigned>(words);
+  memcpy(store, data, words * sizeof(unsigned));
+  return new i::ScriptDataImpl(i::Vector<unsigned>(store, words));
+}
+
+
+// --- P r e C o m p i l e T a s k ---
+
+
+PreCompileTask* PreCompileTask::Start(v8::Handle<String> source) {
+  i::PreCompileTaskImpl* task =
+      new i::PreCompileTaskImpl(Utils::OpenHandle(*source));
+  task->i::Thread::Start();
+  return task;
+}
+
+
 // --- S c r i p t ---
 
 
@@ -1026,12 +1054,18 @@ Local<Script> Script::Compile(v8::Handle<String> source,
   }
   EXCEPTION_PREAMBLE();
   i::ScriptDataImpl* pre_data = static_cast<i::ScriptDataImpl*>(script_data);
-  // We assert that the pre-data is sane, even though we can actually
-  // handle it if it turns out not to be in release mode.
-  ASSERT(pre_data == NULL || pre_data->SanityCheck());
-  // If the pre-data isn't sane we simply ignore it
-  if (pre_data != NULL && !pre_data->SanityCheck())
+  // Pre-data can come from ScriptData::New with bytes stored by the
+  // embedder, so it may be corrupt or from another version of V8.  If
+  // it isn't sane we simply ignore it.
+  if (pre_data != NULL && !pre_data->SanityCheck()) {
+    pre_data->set_rejected();
     pre_data = NULL;
+  }
+  // Data bound to a source is only used for that source.
+  if (pre_data != NULL && !pre_data->MatchesSource(str)) {
+    pre_data->set_rejected();
+    pre_data = NULL;
+  }
   i::Handle<i::JSFunction> boilerplate = i::Compiler::Compile(str,
                                                               name_obj,
                                                               line_offset,
@@ -2113,6 +2147,12 @@ Persistent<Context> v8::Context::New(v8::ExtensionConfiguration* extensions,
                 "v8::Context::New()",
                 "Could not initialize environment"))
     return Persistent<Context>();
+  // The startup scripts are user code, so they run outside the
+  // bootstrapper and not in internal contexts such as the debugger's.
+  if (!ApiCheck(i::Bootstrapper::RunStartupScripts(env),
+                "v8::Context::New()",
+                "Error running startup script"))
+    return Persistent<Context>();
   return Persistent<Context>(Utils::ToLocal(env));
 }
 
@@ -2485,6 +2525,20 @@ void V8::SetGlobalGCEpilogueCallback(GCCallback callback) {
 }
 
 
+bool V8::IdleNotification() {
+  if (IsDeadCheck("v8::V8::IdleNotification()")) return true;
+  if (!i::Heap::HasBeenSetup()) return true;
+  return i::Heap::IdleNotification();
+}
+
+
+void V8::PrintICStatistics(FILE* out) {
+  if (IsDeadCheck("v8::V8::PrintICStatistics()")) return;
+  if (!i::Heap::HasBeenSetup()) return;
+  i::ICStats::Print(out);
+}
+
+
 String::AsciiValue::AsciiValue(v8::Handle<v8::Value> obj) {
   EnsureInitialized("v8::String::AsciiValue::AsciiValue()");
   HandleScope scope;
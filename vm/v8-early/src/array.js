@@ -646,7 +646,8 @@ function ArraySplice(start, delete_count) {
 
 
 function ArraySort(comparefn) {
-  // Standard in-place HeapSort algorithm.
+  // Standard in-place HeapSort algorithm, used for arrays that are not
+  // sorted natively by %SortFastElements.
 
   function Compare(x,y) {
     if (IS_UNDEFINED(x)) {
@@ -668,46 +669,51 @@ function ArraySort(comparefn) {
 
   %RemoveArrayHoles(this);
 
-  var length = ToUint32(this.length);
-
-  // Bottom-up max-heap construction.
-  for (var i = 1; i < length; ++i) {
-    var child_index = i;
-    while (child_index > 0) {
-      var parent_index = ((child_index + 1) >> 1) - 1;
-      var parent_value = this[parent_index], child_value = this[child_index];
-      if (Compare(parent_value, child_value) < 0) {
-        this[parent_index] = child_value; 
-        this[child_index] = parent_value;
-      } else {
-        break;
+  // Arrays with fast elements are sorted natively unless the
+  // comparison function has to be called.  Everything else uses the
+  // heap sort below.
+  if (!%SortFastElements(this, comparefn)) {
+    var length = ToUint32(this.length);
+
+    // Bottom-up max-heap construction.
+    for (var i = 1; i < length; ++i) {
+      var child_index = i;
+      while (child_index > 0) {
+        var parent_index = ((child_index + 1) >> 1) - 1;
+        var parent_value = this[parent_index], child_value = this[child_index];
+        if (Compare(parent_value, child_value) < 0) {
+          this[parent_index] = child_value; 
+          this[child_index] = parent_value;
+        } else {
+          break;
+        }
+        child_index = parent_index;
       }
-      child_index = parent_index;
     }
-  }
 
-  // Extract element and create sorted array.
-  for (var i = length - 1; i > 0; --i) {
-    // Put the max element at the back of the array.
-    var t0 = this[0]; this[0] = this[i]; this[i] = t0;
-    // Sift down the new top element.
-    var parent_index = 0;
-    while (true) {
-      var child_index = ((parent_index + 1) << 1) - 1;
-      if (child_index >= i) break;
-      var child1_value = this[child_index]; 
-      var child2_value = this[child_index + 1];
-      var parent_value = this[parent_index];
-      if (child_index + 1 >= i || Compare(child1_value, child2_value) > 0) {
-        if (Compare(parent_value, child1_value) > 0) break;
-        this[child_index] = parent_value; 
-        this[parent_index] = child1_value;
-        parent_index = child_index;
-      } else {
-        if (Compare(parent_value, child2_value) > 0) break;
-        this[child_index + 1] = parent_value; 
-        this[parent_index] = child2_value;
-        parent_index = child_index + 1;
+    // Extract element and create sorted array.
+    for (var i = length - 1; i > 0; --i) {
+      // Put the max element at the back of the array.
+      var t0 = this[0]; this[0] = this[i]; this[i] = t0;
+      // Sift down the new top element.
+      var parent_index = 0;
+      while (true) {
+        var child_index = ((parent_index + 1) << 1) - 1;
+        if (child_index >= i) break;
+        var child1_value = this[child_index]; 
+        var child2_value = this[child_index + 1];
+        var parent_value = this[parent_index];
+        if (child_index + 1 >= i || Compare(child1_value, child2_value) > 0) {
+          if (Compare(parent_value, child1_value) > 0) break;
+          this[child_index] = parent_value; 
+          this[parent_index] = child1_value;
+          parent_index = child_index;
+        } else {
+          if (Compare(parent_value, child2_value) > 0) break;
+          this[child_index + 1] = parent_value; 
+          this[parent_index] = child2_value;
+          parent_index = child_index + 1;
+        }
       }
     }
   }
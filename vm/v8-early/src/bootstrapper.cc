@@ -36,6 +36,7 @@
 #include "global-handles.h"
 #include "macro-assembler.h"
 #include "natives.h"
+#include "stub-cache.h"
 
 namespace v8 { namespace internal {
 
@@ -90,6 +91,13 @@ class SourceCodeCache BASE_EMBEDDED {
     Script::cast(fun->shared()->script())->set_type(Smi::FromInt(type_));
   }
 
+  // Number of (name, function) pairs in the cache.
+  int size() { return cache_->length() / 2; }
+
+  JSFunction* function_at(int index) {
+    return JSFunction::cast(cache_->get(index * 2 + 1));
+  }
+
  private:
   ScriptType type_;
   FixedArray* cache_;
@@ -98,6 +106,10 @@ class SourceCodeCache BASE_EMBEDDED {
 
 static SourceCodeCache natives_cache(SCRIPT_TYPE_NATIVE);
 static SourceCodeCache extensions_cache(SCRIPT_TYPE_EXTENSION);
+// Scripts run in every new global context after the extensions have
+// been installed.  The cache is part of the snapshot, so contexts
+// created from a snapshot run them without compiling them.
+static SourceCodeCache startup_scripts_cache(SCRIPT_TYPE_NORMAL);
 
 
 Handle<String> Bootstrapper::NativesSourceLookup(int index) {
@@ -124,15 +136,42 @@ void Bootstrapper::NativesCacheAdd(Vector<const char> name,
 }
 
 
+bool Bootstrapper::AddStartupScript(Vector<const char> name,
+                                   Handle<String> source) {
+  HandleScope scope;
+  Handle<String> script_name = Factory::NewStringFromUtf8(name);
+  Handle<JSFunction> boilerplate =
+      Compiler::Compile(source, script_name, 0, 0, NULL, NULL);
+  if (boilerplate.is_null()) return false;
+  startup_scripts_cache.Add(name, boilerplate);
+  bool has_pending_exception;
+  RunStartupScript(boilerplate, &has_pending_exception);
+  return !has_pending_exception;
+}
+
+
+void Bootstrapper::RunStartupScript(Handle<JSFunction> boilerplate,
+                                    bool* has_pending_exception) {
+  ASSERT(Top::context()->IsGlobalContext());
+  Handle<Context> context(Top::context());
+  Handle<JSFunction> fun =
+      Factory::NewFunctionFromBoilerplate(boilerplate, context);
+  Handle<Object> receiver(Top::context()->global());
+  Execution::Call(fun, receiver, 0, NULL, has_pending_exception);
+}
+
+
 void Bootstrapper::Initialize(bool create_heap_objects) {
   natives_cache.Initialize(create_heap_objects);
   extensions_cache.Initialize(create_heap_objects);
+  startup_scripts_cache.Initialize(create_heap_objects);
 }
 
 
 void Bootstrapper::TearDown() {
   natives_cache.Initialize(false);  // Yes, symmetrical
   extensions_cache.Initialize(false);
+  startup_scripts_cache.Initialize(false);
 }
 
 
@@ -298,6 +337,12 @@ class Genesis BASE_EMBEDDED {
 
   void BuildSpecialFunctionTable();
 
+  void AddIntrinsicFunction(Handle<JSObject> holder,
+                            const char* name,
+                            StubCompiler::Intrinsic id);
+
+  void BuildIntrinsicFunctionTable();
+
   static bool CompileBuiltin(int index);
   static bool CompileNative(Vector<const char> name, Handle<String> source);
   static bool CompileScriptCached(Vector<const char> name,
@@ -315,6 +360,7 @@ Genesis* Genesis::current_ = NULL;
 void Bootstrapper::Iterate(ObjectVisitor* v) {
   natives_cache.Iterate(v);
   extensions_cache.Iterate(v);
+  startup_scripts_cache.Iterate(v);
   PendingFixups::Iterate(v);
 }
 
@@ -340,6 +386,24 @@ Handle<Context> Bootstrapper::CreateEnvironment(
 }
 
 
+bool Bootstrapper::RunStartupScripts(Handle<Context> context) {
+  SaveContext saved_context;
+  Top::set_context(*context);
+  Top::set_security_context(*context);
+  for (int i = 0; i < startup_scripts_cache.size(); i++) {
+    HandleScope scope;
+    Handle<JSFunction> boilerplate(startup_scripts_cache.function_at(i));
+    bool has_pending_exception;
+    RunStartupScript(boilerplate, &has_pending_exception);
+    if (has_pending_exception) {
+      Top::clear_pending_exception();
+      return false;
+    }
+  }
+  return true;
+}
+
+
 Genesis::~Genesis() {
   ASSERT(current_ == this);
   current_ = previous_;
@@ -707,6 +771,7 @@ void Genesis::CreateRoots(v8::Handle<v8::ObjectTemplate> global_template,
   global_context()->set_call_as_function_delegate(*delegate);
 
   global_context()->set_special_function_table(Heap::empty_fixed_array());
+  global_context()->set_intrinsic_function_table(Heap::empty_fixed_array());
 
   // Initialize the out of memory slot.
   global_context()->set_out_of_memory(Heap::false_value());
@@ -1265,6 +1330,48 @@ void Genesis::BuildSpecialFunctionTable() {
 }
 
 
+void Genesis::AddIntrinsicFunction(Handle<JSObject> holder,
+                                   const char* name,
+                                   StubCompiler::Intrinsic id) {
+  Handle<String> key = Factory::LookupAsciiSymbol(name);
+  Handle<Object> value = Handle<Object>(holder->GetProperty(*key));
+  if (value->IsJSFunction()) {
+    int len = global_context()->intrinsic_function_table()->length();
+    Handle<FixedArray> new_array = Factory::NewFixedArray(len + 2);
+    for (int index = 0; index < len; index++) {
+      new_array->set(index,
+                     global_context()->intrinsic_function_table()->get(index));
+    }
+    new_array->set(len+0, *value);
+    new_array->set(len+1, Smi::FromInt(id));
+    global_context()->set_intrinsic_function_table(*new_array);
+  }
+}
+
+
+void Genesis::BuildIntrinsicFunctionTable() {
+  HandleScope scope;
+  Handle<JSObject> global = Handle<JSObject>(global_context()->global());
+  // Math functions that are the identity on smis or cheap to compute.
+  Handle<Object> math =
+      Handle<Object>(global->GetProperty(*Factory::LookupAsciiSymbol("Math")));
+  if (math->IsJSObject()) {
+    Handle<JSObject> holder = Handle<JSObject>::cast(math);
+    AddIntrinsicFunction(holder, "abs", StubCompiler::MATH_ABS);
+    AddIntrinsicFunction(holder, "floor", StubCompiler::MATH_FLOOR);
+    AddIntrinsicFunction(holder, "ceil", StubCompiler::MATH_CEIL);
+    AddIntrinsicFunction(holder, "round", StubCompiler::MATH_ROUND);
+  }
+  // Character access on flat strings.
+  Handle<JSFunction> string_function =
+      Handle<JSFunction>(global_context()->string_function());
+  Handle<JSObject> string_prototype = Handle<JSObject>(
+      JSObject::cast(string_function->instance_prototype()));
+  AddIntrinsicFunction(string_prototype, "charCodeAt",
+                       StubCompiler::STRING_CHAR_CODE_AT);
+}
+
+
 Genesis::Genesis(Handle<Object> global_object,
                  v8::Handle<v8::ObjectTemplate> global_template,
                  v8::ExtensionConfiguration* extensions) {
@@ -1288,6 +1395,7 @@ Genesis::Genesis(Handle<Object> global_object,
 
   MakeFunctionInstancePrototypeWritable();
   BuildSpecialFunctionTable();
+  BuildIntrinsicFunctionTable();
   if (!ConfigureGlobalObject(global_template)) return;
 
   if (!InstallExtensions(extensions)) return;
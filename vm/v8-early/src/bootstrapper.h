@@ -55,6 +55,23 @@ class Bootstrapper : public AllStatic {
                                  Handle<JSFunction>* handle);
   static void NativesCacheAdd(Vector<const char> name, Handle<JSFunction> fun);
 
+  // Compiles a startup script and runs it in the current global
+  // context.  Startup scripts are also run in every global context
+  // created afterwards, and are included in snapshots so contexts
+  // created from a snapshot do not have to compile them.  Returns
+  // false if the script could not be compiled or threw an exception.
+  static bool AddStartupScript(Vector<const char> name,
+                               Handle<String> source);
+
+  // Runs a compiled startup script in the current global context.
+  static void RunStartupScript(Handle<JSFunction> boilerplate,
+                               bool* has_pending_exception);
+
+  // Runs all cached startup scripts in the given global context.  Only
+  // called for embedder contexts, after bootstrapping has finished.
+  // Returns false if one of them threw an exception.
+  static bool RunStartupScripts(Handle<Context> context);
+
   // Append code that needs fixup at the end of boot strapping.
   static void AddFixup(Code* code, MacroAssembler* masm);
 
@@ -254,6 +254,15 @@ class Ia32CodeGenerator: public CodeGenerator {
   void GenericOperation(Token::Value op,
                         OverwriteMode overwrite_mode = NO_OVERWRITE);
 
+  // Binary operations and comparisons on operands that are already in
+  // registers: the left operand in edx and the right operand in eax.
+  // Used directly when both operands are stack allocated variables,
+  // which avoids moving them through the expression stack.
+  bool HasRegisterOperation(Token::Value op);
+  void RegisterOperation(Token::Value op, OverwriteMode overwrite_mode);
+  void RegisterComparison(Condition cc, bool strict);
+  void LoadToRegister(Expression* x, Register reg);
+
   bool InlinedGenericOperation(
       Token::Value op,
       const OverwriteMode overwrite_mode = NO_OVERWRITE,
@@ -696,6 +705,29 @@ void Ia32CodeGenerator::LoadCondition(Expression* x,
 }
 
 
+// Returns the slot of x if x is a non-constant variable allocated on the
+// stack, NULL otherwise. Such variables can be loaded into registers
+// without any checks.
+static Slot* StackSlotOf(Expression* x) {
+  Variable* var = x->AsVariableProxy()->AsVariable();
+  if (var == NULL || var->mode() == Variable::CONST) return NULL;
+  Slot* slot = var->slot();
+  if (slot == NULL) return NULL;
+  if (slot->type() != Slot::PARAMETER && slot->type() != Slot::LOCAL) {
+    return NULL;
+  }
+  return slot;
+}
+
+
+void Ia32CodeGenerator::LoadToRegister(Expression* x, Register reg) {
+  Slot* slot = StackSlotOf(x);
+  ASSERT(slot != NULL);
+  Comment cmnt(masm_, "[ LoadToRegister");
+  __ mov(reg, SlotOperand(slot, no_reg));
+}
+
+
 void Ia32CodeGenerator::Load(Expression* x, CodeGenState::AccessType access) {
   ASSERT(access == CodeGenState::LOAD ||
          access == CodeGenState::LOAD_TYPEOF_EXPR);
@@ -1666,14 +1698,52 @@ void ArgumentsAccessStub::Generate(MacroAssembler* masm) {
 #define __  masm_->
 
 
+// Deferred code for the inlined smi cases of binary operations on
+// register operands. Entered with x in edx and y in eax.
+class DeferredInlinedBinaryOperation: public DeferredCode {
+ public:
+  DeferredInlinedBinaryOperation(CodeGenerator* generator,
+                                 Token::Value op,
+                                 OverwriteMode overwrite_mode)
+      : DeferredCode(generator), op_(op), overwrite_mode_(overwrite_mode) {
+    set_comment("[ DeferredInlinedBinaryOperation");
+  }
+
+  virtual void Generate() {
+    __ push(edx);
+    if (op_ == Token::MOD) {
+      // The modulus stub takes y in eax.
+      GenericOpStub stub(op_);
+      __ CallStub(&stub);
+    } else {
+      __ push(eax);
+      InlinedGenericOpStub igostub(op_, overwrite_mode_, false);
+      __ CallStub(&igostub);
+    }
+  }
+
+ private:
+  Token::Value op_;
+  OverwriteMode overwrite_mode_;
+};
+
+
 // Return true if code was generated for operation 'type'.
 // NOTE: The code below assumes that the slow cases (calls to runtime)
 // never return a constant/immutable object.
-// TODO(1217800): MOD is not yet implemented.
 bool Ia32CodeGenerator::InlinedGenericOperation(
     Token::Value op,
     const OverwriteMode overwrite_mode,
     bool negate_result) {
+  // Handle the smi case inline and only call the stub if an operand is
+  // not a smi or the result is not a smi.
+  if (!negate_result && HasRegisterOperation(op)) {
+    __ pop(eax);  // get y
+    __ pop(edx);  // get x
+    RegisterOperation(op, overwrite_mode);
+    return true;
+  }
+
   const char* comment = NULL;
   if (negate_result) {
     switch (op) {
@@ -1714,10 +1784,164 @@ void Ia32CodeGenerator::GenericOperation(Token::Value op,
 
     case Token::BIT_OR:
     case Token::BIT_AND:
-    case Token::BIT_XOR: {
-      Label slow, exit;
+    case Token::BIT_XOR:
+    case Token::SHL:
+    case Token::SHR:
+    case Token::SAR:
       __ pop(eax);  // get y
       __ pop(edx);  // get x
+      RegisterOperation(op, overwrite_mode);
+      break;
+
+    case Token::COMMA: {
+      // simply discard left value
+      __ pop(eax);
+      __ add(Operand(esp), Immediate(kPointerSize));
+      __ push(eax);
+      break;
+    }
+
+    default:
+      // Other cases should have been handled before this point.
+      UNREACHABLE();
+      break;
+  }
+}
+
+
+bool Ia32CodeGenerator::HasRegisterOperation(Token::Value op) {
+  switch (op) {
+    case Token::BIT_OR:
+    case Token::BIT_AND:
+    case Token::BIT_XOR:
+    case Token::SHL:
+    case Token::SHR:
+    case Token::SAR:
+    case Token::ADD:
+    case Token::SUB:
+    case Token::MUL:
+    case Token::DIV:
+    case Token::MOD:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+void Ia32CodeGenerator::RegisterOperation(Token::Value op,
+                                          OverwriteMode overwrite_mode) {
+  ASSERT(HasRegisterOperation(op));
+  switch (op) {
+    case Token::ADD:
+    case Token::SUB: {
+      Comment cmnt(masm_, "[ InlinedBinaryOperation");
+      DeferredCode* deferred =
+          new DeferredInlinedBinaryOperation(this, op, overwrite_mode);
+      __ mov(ecx, Operand(edx));
+      __ or_(ecx, Operand(eax));
+      ASSERT(kSmiTag == 0);  // adjust code below
+      __ test(ecx, Immediate(kSmiTagMask));
+      __ j(not_zero, deferred->enter(), not_taken);
+      __ mov(ecx, Operand(edx));
+      if (op == Token::ADD) {
+        __ add(ecx, Operand(eax));
+      } else {
+        __ sub(ecx, Operand(eax));
+      }
+      __ j(overflow, deferred->enter(), not_taken);
+      __ mov(eax, Operand(ecx));
+      __ bind(deferred->exit());
+      __ push(eax);
+      break;
+    }
+
+    case Token::MUL: {
+      DeferredCode* deferred =
+          new DeferredInlinedBinaryOperation(this, op, overwrite_mode);
+      Label non_zero;
+      __ mov(ecx, Operand(edx));
+      __ or_(ecx, Operand(eax));
+      ASSERT(kSmiTag == 0);  // adjust code below
+      __ test(ecx, Immediate(kSmiTagMask));
+      __ j(not_zero, deferred->enter(), not_taken);
+      // Multiplying the untagged x with the tagged y gives the tagged
+      // result.
+      __ mov(ebx, Operand(edx));
+      __ sar(ebx, kSmiTagSize);
+      __ imul(ebx, Operand(eax));
+      __ j(overflow, deferred->enter(), not_taken);
+      // A zero result is -0 if either operand is negative.
+      __ test(ebx, Operand(ebx));
+      __ j(not_zero, &non_zero, taken);
+      __ test(ecx, Operand(ecx));
+      __ j(sign, deferred->enter(), not_taken);
+      __ bind(&non_zero);
+      __ mov(eax, Operand(ebx));
+      __ bind(deferred->exit());
+      __ push(eax);
+      break;
+    }
+
+    case Token::DIV:
+    case Token::MOD: {
+      DeferredCode* deferred =
+          new DeferredInlinedBinaryOperation(this, op, overwrite_mode);
+      Label restore;
+      __ mov(ecx, Operand(edx));
+      __ or_(ecx, Operand(eax));
+      ASSERT(kSmiTag == 0);  // adjust code below
+      __ test(ecx, Immediate(kSmiTagMask));
+      __ j(not_zero, deferred->enter(), not_taken);
+      // Division by zero gives a non-smi result.
+      __ test(eax, Operand(eax));
+      __ j(zero, deferred->enter(), not_taken);
+      if (op == Token::DIV) {
+        // Zero divided by a negative number is -0.
+        __ test(edx, Operand(edx));
+        __ j(zero, deferred->enter(), not_taken);
+      }
+      // Divide the tagged operands. The quotient is untagged and the
+      // remainder is tagged. Keep copies of the operands in ebx and
+      // ecx for the slow case.
+      __ mov(ebx, Operand(edx));
+      __ mov(ecx, Operand(eax));
+      __ mov(eax, Operand(edx));
+      __ cdq();
+      __ idiv(ecx);
+      if (op == Token::DIV) {
+        // The result is only a smi if the division is exact and does
+        // not overflow, which only happens for -0x40000000 / -1.
+        __ test(edx, Operand(edx));
+        __ j(not_zero, &restore, not_taken);
+        __ cmp(eax, 0x40000000);
+        __ j(equal, &restore, not_taken);
+        ASSERT(kSmiTagSize == times_2);  // adjust code if not the case
+        __ lea(eax, Operand(eax, times_2, kSmiTag));
+      } else {
+        // A zero remainder is -0 if the dividend is negative.
+        Label non_zero;
+        __ test(edx, Operand(edx));
+        __ j(not_zero, &non_zero, taken);
+        __ test(ebx, Operand(ebx));
+        __ j(sign, &restore, not_taken);
+        __ bind(&non_zero);
+        __ mov(eax, Operand(edx));
+      }
+      __ jmp(deferred->exit());
+      __ bind(&restore);
+      __ mov(edx, Operand(ebx));
+      __ mov(eax, Operand(ecx));
+      __ jmp(deferred->enter());
+      __ bind(deferred->exit());
+      __ push(eax);
+      break;
+    }
+
+    case Token::BIT_OR:
+    case Token::BIT_AND:
+    case Token::BIT_XOR: {
+      Label slow, exit;
       __ mov(ecx, Operand(edx));  // prepare smi check
       // tag check
       __ or_(ecx, Operand(eax));  // ecx = x | y;
@@ -1745,8 +1969,6 @@ void Ia32CodeGenerator::GenericOperation(Token::Value op,
     case Token::SHR:
     case Token::SAR: {
       Label slow, exit;
-      __ pop(edx);  // get y
-      __ pop(eax);  // get x
       // tag check
       __ mov(ecx, Operand(edx));
       __ or_(ecx, Operand(eax));  // ecx = x | y;
@@ -1754,8 +1976,8 @@ void Ia32CodeGenerator::GenericOperation(Token::Value op,
       __ test(ecx, Immediate(kSmiTagMask));
       __ j(not_zero, &slow, not_taken);
       // get copies of operands
-      __ mov(ebx, Operand(eax));
-      __ mov(ecx, Operand(edx));
+      __ mov(ebx, Operand(edx));
+      __ mov(ecx, Operand(eax));
       // remove tags from operands (but keep sign)
       __ sar(ebx, kSmiTagSize);
       __ sar(ecx, kSmiTagSize);
@@ -1794,25 +2016,16 @@ void Ia32CodeGenerator::GenericOperation(Token::Value op,
       __ jmp(&exit);
       // slow case
       __ bind(&slow);
-      __ push(eax);  // restore stack
-      __ push(edx);
-        InlinedGenericOpStub stub(op, overwrite_mode, false);
+      __ push(edx);  // restore stack
+      __ push(eax);
+      InlinedGenericOpStub stub(op, overwrite_mode, false);
       __ CallStub(&stub);
       __ bind(&exit);
       __ push(eax);
       break;
     }
 
-    case Token::COMMA: {
-      // simply discard left value
-      __ pop(eax);
-      __ add(Operand(esp), Immediate(kPointerSize));
-      __ push(eax);
-      break;
-    }
-
     default:
-      // Other cases should have been handled before this point.
       UNREACHABLE();
       break;
   }
@@ -2021,10 +2234,9 @@ void Ia32CodeGenerator::SmiOperation(Token::Value op,
 
     case Token::SAR: {
       if (reversed) {
-        __ pop(eax);
-        __ push(Immediate(value));
-        __ push(eax);
-        GenericOperation(op);
+        __ pop(eax);  // get y
+        __ Set(edx, Immediate(value));
+        RegisterOperation(op, overwrite_mode);
       } else {
         int shift_value = int_value & 0x1f;  // only least significant 5 bits
         DeferredCode* deferred =
@@ -2043,10 +2255,9 @@ void Ia32CodeGenerator::SmiOperation(Token::Value op,
 
     case Token::SHR: {
       if (reversed) {
-        __ pop(eax);
-        __ push(Immediate(value));
-        __ push(eax);
-        GenericOperation(op);
+        __ pop(eax);  // get y
+        __ Set(edx, Immediate(value));
+        RegisterOperation(op, overwrite_mode);
       } else {
         int shift_value = int_value & 0x1f;  // only least significant 5 bits
         DeferredCode* deferred =
@@ -2071,10 +2282,9 @@ void Ia32CodeGenerator::SmiOperation(Token::Value op,
 
     case Token::SHL: {
       if (reversed) {
-        __ pop(eax);
-        __ push(Immediate(value));
-        __ push(eax);
-        GenericOperation(op);
+        __ pop(eax);  // get y
+        __ Set(edx, Immediate(value));
+        RegisterOperation(op, overwrite_mode);
       } else {
         int shift_value = int_value & 0x1f;  // only least significant 5 bits
         DeferredCode* deferred =
@@ -2125,7 +2335,65 @@ void Ia32CodeGenerator::SmiOperation(Token::Value op,
       break;
     }
 
+    case Token::MUL: {
+      DeferredCode* deferred = NULL;
+      if (!reversed) {
+        deferred = new DeferredInlinedSmiOperation(this, op, int_value,
+                                                   overwrite_mode);
+      } else {
+        deferred = new DeferredInlinedSmiOperationReversed(this, op, int_value,
+                                                           overwrite_mode);
+      }
+      __ pop(eax);
+      __ test(eax, Immediate(kSmiTagMask));
+      __ j(not_zero, deferred->enter(), not_taken);
+      __ imul(ebx, eax, int_value);
+      __ j(overflow, deferred->enter(), not_taken);
+      // Check for a -0 result.
+      if (int_value < 0) {
+        __ test(ebx, Operand(ebx));
+        __ j(zero, deferred->enter(), not_taken);
+      } else if (int_value == 0) {
+        __ test(eax, Operand(eax));
+        __ j(sign, deferred->enter(), not_taken);
+      }
+      __ mov(eax, Operand(ebx));
+      __ bind(deferred->exit());
+      __ push(eax);
+      break;
+    }
+
+    case Token::MOD: {
+      if (!reversed && int_value > 0 && IsPowerOf2(int_value)) {
+        // Non-negative smis modulo a power of two only need masking.
+        DeferredCode* deferred =
+            new DeferredInlinedBinaryOperation(this, op, overwrite_mode);
+        __ pop(edx);
+        __ Set(eax, Immediate(value));
+        __ test(edx, Immediate(kSmiTagMask | 0x80000000));
+        __ j(not_zero, deferred->enter(), not_taken);
+        __ mov(eax, Operand(edx));
+        __ and_(eax, (int_value << kSmiTagSize) - 1);
+        __ bind(deferred->exit());
+        __ push(eax);
+        break;
+      }
+    }
+    // Fall through.
+
     default: {
+      if (HasRegisterOperation(op)) {
+        // Use the constant as a register operand instead of pushing it.
+        if (!reversed) {
+          __ pop(edx);
+          __ Set(eax, Immediate(value));
+        } else {
+          __ pop(eax);
+          __ Set(edx, Immediate(value));
+        }
+        RegisterOperation(op, overwrite_mode);
+        break;
+      }
       if (!reversed) {
         __ push(Immediate(value));
       } else {
@@ -2290,9 +2558,14 @@ void Ia32CodeGenerator::Comparison(Condition cc, bool strict) {
   // Strict only makes sense for equality comparisons.
   ASSERT(!strict || cc == equal);
 
-  ComparisonDeferred* deferred = new ComparisonDeferred(this, cc, strict);
   __ pop(eax);
   __ pop(edx);
+  RegisterComparison(cc, strict);
+}
+
+
+void Ia32CodeGenerator::RegisterComparison(Condition cc, bool strict) {
+  ComparisonDeferred* deferred = new ComparisonDeferred(this, cc, strict);
   __ mov(ecx, Operand(eax));
   __ or_(ecx, Operand(edx));
   __ test(ecx, Immediate(kSmiTagMask));
@@ -4388,8 +4661,15 @@ void Ia32CodeGenerator::VisitCountOperation(CountOperation* node) {
 
     // Store the new value in the target if not const.
     __ bind(deferred->exit());
-    __ push(eax);  // Push the new value to TOS
-    if (!is_const) SetValue(&target);
+    Slot* slot = StackSlotOf(node->expression());
+    if (slot != NULL) {
+      // Store directly from the register.
+      __ mov(SlotOperand(slot, ecx), eax);
+      __ push(eax);
+    } else {
+      __ push(eax);  // Push the new value to TOS
+      if (!is_const) SetValue(&target);
+    }
   }
 
   // Postfix: Discard the new value and use the old.
@@ -4522,6 +4802,13 @@ void Ia32CodeGenerator::VisitBinaryOperation(BinaryOperation* node) {
       Load(node->right());
       SmiOperation(node->op(), lliteral->handle(), true, overwrite_mode);
 
+    } else if (HasRegisterOperation(op) &&
+               StackSlotOf(node->left()) != NULL &&
+               StackSlotOf(node->right()) != NULL) {
+      LoadToRegister(node->left(), edx);
+      LoadToRegister(node->right(), eax);
+      RegisterOperation(op, overwrite_mode);
+
     } else {
       bool negate_result = false;
       if (node->op() == Token::MUL) {  // Implement only MUL for starters
@@ -4750,6 +5037,13 @@ void Ia32CodeGenerator::VisitCompareOperation(CompareOperation* node) {
     return;
   }
 
+  if (StackSlotOf(left) != NULL && StackSlotOf(right) != NULL) {
+    LoadToRegister(left, edx);
+    LoadToRegister(right, eax);
+    RegisterComparison(cc, strict);
+    return;
+  }
+
   Load(left);
   Load(right);
   Comparison(cc, strict);
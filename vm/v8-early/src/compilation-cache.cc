@@ -0,0 +1,210 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "compilation-cache.h"
+
+namespace v8 { namespace internal {
+
+DEFINE_bool(compilation_cache, true, "enable compilation cache");
+
+enum {
+  SCRIPT,
+  EVAL_GLOBAL,
+  EVAL_CONTEXTUAL,
+  NUMBER_OF_TABLE_ENTRIES
+};
+
+
+// Number of generations an entry survives without being used.
+static const int kGenerations = 4;
+
+// Initial size of each compilation cache table allocated.
+static const int kInitialCacheSize = 64;
+
+// The tables for each kind of entry, youngest generation first. Entries
+// are undefined when the generation is empty.
+static Object* tables[NUMBER_OF_TABLE_ENTRIES][kGenerations];
+
+
+static Handle<CompilationCacheTable> AllocateTable(int size) {
+  CALL_HEAP_FUNCTION(CompilationCacheTable::Allocate(size),
+                     CompilationCacheTable);
+}
+
+
+static Handle<CompilationCacheTable> PutInTable(
+    Handle<CompilationCacheTable> table,
+    Handle<String> source,
+    Handle<JSFunction> boilerplate) {
+  CALL_HEAP_FUNCTION(table->Put(*source, *boilerplate),
+                     CompilationCacheTable);
+}
+
+
+// Returns the boilerplate for the source in the given kind of entries,
+// or null if it is not in any generation. Entries found in an older
+// generation are moved to the youngest one.
+static JSFunction* Lookup(int entry, String* source) {
+  for (int generation = 0; generation < kGenerations; generation++) {
+    Object* table = tables[entry][generation];
+    if (table->IsUndefined()) continue;
+    Object* result = CompilationCacheTable::cast(table)->Lookup(source);
+    if (result->IsJSFunction()) return JSFunction::cast(result);
+  }
+  return NULL;
+}
+
+
+static void Put(int entry,
+                Handle<String> source,
+                Handle<JSFunction> boilerplate) {
+  HandleScope scope;
+  Handle<CompilationCacheTable> table;
+  if (tables[entry][0]->IsUndefined()) {
+    table = AllocateTable(kInitialCacheSize);
+  } else {
+    table = Handle<CompilationCacheTable>(
+        CompilationCacheTable::cast(tables[entry][0]));
+  }
+  if (table.is_null()) return;
+  Handle<CompilationCacheTable> result =
+      PutInTable(table, source, boilerplate);
+  if (!result.is_null()) tables[entry][0] = *result;
+}
+
+
+// Returns true if the boilerplate was compiled from a script with the
+// given origin.
+static bool HasOrigin(JSFunction* boilerplate,
+                      Object* name,
+                      int line_offset,
+                      int column_offset) {
+  Script* script = Script::cast(boilerplate->shared()->script());
+  if (name->IsString()) {
+    // Compare the script name, line offset and column offset.
+    if (!script->name()->IsString()) return false;
+    if (!String::cast(name)->Equals(String::cast(script->name()))) {
+      return false;
+    }
+    return Smi::cast(script->line_offset())->value() == line_offset &&
+        Smi::cast(script->column_offset())->value() == column_offset;
+  }
+  // Scripts without a name are not associated with an origin.
+  return !script->name()->IsString();
+}
+
+
+static Handle<JSFunction> Hit(int entry,
+                              Handle<String> source,
+                              JSFunction* boilerplate) {
+  Counters::compilation_cache_hits.Increment();
+  Handle<JSFunction> result(boilerplate);
+  // Move the entry to the youngest generation unless it is there
+  // already.
+  if (tables[entry][0]->IsUndefined() ||
+      CompilationCacheTable::cast(tables[entry][0])->Lookup(*source) !=
+          boilerplate) {
+    Put(entry, source, result);
+  }
+  return result;
+}
+
+
+Handle<JSFunction> CompilationCache::LookupScript(Handle<String> source,
+                                                  Handle<Object> name,
+                                                  int line_offset,
+                                                  int column_offset) {
+  if (!FLAG_compilation_cache) return Handle<JSFunction>::null();
+  JSFunction* result = Lookup(SCRIPT, *source);
+  if (result == NULL ||
+      !HasOrigin(result, *name, line_offset, column_offset)) {
+    Counters::compilation_cache_misses.Increment();
+    return Handle<JSFunction>::null();
+  }
+  return Hit(SCRIPT, source, result);
+}
+
+
+Handle<JSFunction> CompilationCache::LookupEval(Handle<String> source,
+                                                bool is_global) {
+  if (!FLAG_compilation_cache) return Handle<JSFunction>::null();
+  int entry = is_global ? EVAL_GLOBAL : EVAL_CONTEXTUAL;
+  JSFunction* result = Lookup(entry, *source);
+  if (result == NULL) {
+    Counters::compilation_cache_misses.Increment();
+    return Handle<JSFunction>::null();
+  }
+  return Hit(entry, source, result);
+}
+
+
+void CompilationCache::PutScript(Handle<String> source,
+                                 Handle<JSFunction> boilerplate) {
+  if (!FLAG_compilation_cache) return;
+  ASSERT(boilerplate->IsBoilerplate());
+  Put(SCRIPT, source, boilerplate);
+}
+
+
+void CompilationCache::PutEval(Handle<String> source,
+                               bool is_global,
+                               Handle<JSFunction> boilerplate) {
+  if (!FLAG_compilation_cache) return;
+  ASSERT(boilerplate->IsBoilerplate());
+  Put(is_global ? EVAL_GLOBAL : EVAL_CONTEXTUAL, source, boilerplate);
+}
+
+
+void CompilationCache::Age() {
+  for (int i = 0; i < NUMBER_OF_TABLE_ENTRIES; i++) {
+    for (int generation = kGenerations - 1; generation > 0; generation--) {
+      tables[i][generation] = tables[i][generation - 1];
+    }
+    tables[i][0] = Heap::undefined_value();
+  }
+}
+
+
+void CompilationCache::Clear() {
+  for (int i = 0; i < NUMBER_OF_TABLE_ENTRIES; i++) {
+    for (int generation = 0; generation < kGenerations; generation++) {
+      tables[i][generation] = Heap::undefined_value();
+    }
+  }
+}
+
+
+void CompilationCache::Iterate(ObjectVisitor* v) {
+  for (int i = 0; i < NUMBER_OF_TABLE_ENTRIES; i++) {
+    v->VisitPointers(&tables[i][0], &tables[i][kGenerations]);
+  }
+}
+
+
+} }  // namespace v8::internal
@@ -0,0 +1,81 @@
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_COMPILATION_CACHE_H_
+#define V8_COMPILATION_CACHE_H_
+
+namespace v8 { namespace internal {
+
+
+// The compilation cache keeps function boilerplates for compiled
+// scripts and evals. The boilerplates are keyed by their source string
+// and the kind of compilation. Boilerplates are context independent, so
+// a cached one can be instantiated in any context.
+//
+// The cache is generational: new entries go into the youngest generation
+// and every mark-compact collection makes all entries one generation
+// older, dropping the oldest one. Hits on old entries move them back to
+// the youngest generation. When the old generation is exhausted the
+// cache is cleared altogether.
+class CompilationCache : public AllStatic {
+ public:
+  // Finds the script function boilerplate for a source string with the
+  // given origin. Returns an empty handle if the cache doesn't contain
+  // a script for the given source string with the right origin.
+  static Handle<JSFunction> LookupScript(Handle<String> source,
+                                         Handle<Object> name,
+                                         int line_offset,
+                                         int column_offset);
+
+  // Finds the function boilerplate for an eval source string compiled
+  // in a global or non-global context. Returns an empty handle if the
+  // cache doesn't contain the source string.
+  static Handle<JSFunction> LookupEval(Handle<String> source,
+                                       bool is_global);
+
+  // Associates the boilerplate with the source string in the cache.
+  static void PutScript(Handle<String> source,
+                        Handle<JSFunction> boilerplate);
+  static void PutEval(Handle<String> source,
+                      bool is_global,
+                      Handle<JSFunction> boilerplate);
+
+  // Makes all entries one generation older and drops the oldest
+  // generation.
+  static void Age();
+
+  // Clears the cache. Used when memory is low.
+  static void Clear();
+
+  // GC support.
+  static void Iterate(ObjectVisitor* v);
+};
+
+
+} }  // namespace v8::internal
+
+#endif  // V8_COMPILATION_CACHE_H_
@@ -29,6 +29,7 @@
 
 #include "bootstrapper.h"
 #include "codegen-inl.h"
+#include "compilation-cache.h"
 #include "compiler.h"
 #include "debug.h"
 #include "scopes.h"
@@ -191,6 +192,18 @@ Handle<JSFunction> Compiler::Compile(Handle<String> source,
   // The VM is in the COMPILER state until exiting this function.
   VMState state(COMPILER);
 
+  // Do a lookup in the compilation cache. Extensions and the natives
+  // compiled while bootstrapping are not cached.
+  bool use_cache = (extension == NULL) && !Bootstrapper::IsActive();
+  if (use_cache) {
+    Handle<Object> name = Factory::undefined_value();
+    if (!script_name.is_null()) name = script_name;
+    Handle<JSFunction> boilerplate =
+        CompilationCache::LookupScript(source, name,
+                                       line_offset, column_offset);
+    if (!boilerplate.is_null()) return boilerplate;
+  }
+
   ScriptDataImpl* pre_data = input_pre_data;
   if (pre_data == NULL && source->length() >= FLAG_min_preparse_length) {
     Access<SafeStringInputBuffer> buf(&safe_string_input_buffer);
@@ -212,6 +225,10 @@ Handle<JSFunction> Compiler::Compile(Handle<String> source,
   if (input_pre_data == NULL && pre_data != NULL)
     delete pre_data;
 
+  if (use_cache && !result.is_null()) {
+    CompilationCache::PutScript(source, result);
+  }
+
   return result;
 }
 
@@ -224,9 +241,18 @@ Handle<JSFunction> Compiler::CompileEval(bool is_global,
   // The VM is in the COMPILER state until exiting this function.
   VMState state(COMPILER);
 
-  // Create a script object describing the script to be compiled.
-  Handle<Script> script = Factory::NewScript(source);
-  return MakeFunction(is_global, true, script, NULL, NULL);
+  // Do a lookup in the compilation cache; if the entry is not there,
+  // invoke the compiler and add the result to the cache.
+  Handle<JSFunction> result = CompilationCache::LookupEval(source, is_global);
+  if (result.is_null()) {
+    // Create a script object describing the script to be compiled.
+    Handle<Script> script = Factory::NewScript(source);
+    result = MakeFunction(is_global, true, script, NULL, NULL);
+    if (!result.is_null()) {
+      CompilationCache::PutEval(source, is_global, result);
+    }
+  }
+  return result;
 }
 
 
@@ -55,6 +55,11 @@ enum ContextLookupFlags {
 // Primarily added to support built-in optimized variants of
 // Array.prototype.{push,pop}.
 
+// Comment for intrinsic_function_table:
+// Table of builtin functions that call stubs may inline.
+// The array contains pairs [function, intrinsic id (as smi)] where the id
+// is one of the StubCompiler::Intrinsic values.
+
 #define GLOBAL_CONTEXT_FIELDS(V) \
   V(BOOLEAN_FUNCTION_INDEX, JSFunction, boolean_function) \
   V(NUMBER_FUNCTION_INDEX, JSFunction, number_function) \
@@ -79,6 +84,7 @@ enum ContextLookupFlags {
   V(FUNCTION_INSTANCE_MAP_INDEX, Map, function_instance_map) \
   V(JS_ARRAY_MAP_INDEX, Map, js_array_map)\
   V(SPECIAL_FUNCTION_TABLE_INDEX, FixedArray, special_function_table) \
+  V(INTRINSIC_FUNCTION_TABLE_INDEX, FixedArray, intrinsic_function_table) \
   V(ARGUMENTS_BOILERPLATE_INDEX, JSObject, arguments_boilerplate) \
   V(MESSAGE_LISTENERS_INDEX, JSObject, message_listeners) \
   V(DEBUG_EVENT_LISTENERS_INDEX, JSObject, debug_event_listeners) \
@@ -195,6 +201,7 @@ class Context: public FixedArray {
     INSTANTIATE_FUN_INDEX,
     CONFIGURE_INSTANCE_FUN_INDEX,
     SPECIAL_FUNCTION_TABLE_INDEX,
+    INTRINSIC_FUNCTION_TABLE_INDEX,
     MESSAGE_LISTENERS_INDEX,
     DEBUG_EVENT_LISTENERS_INDEX,
     MAKE_MESSAGE_FUN_INDEX,
@@ -302,6 +302,8 @@ enum InlineCacheState {
   MONOMORPHIC,
   // Like MONOMORPHIC but check failed due to prototype.
   MONOMORPHIC_PROTOTYPE_FAILURE,
+  // A few receiver types have been seen; dispatch on the receiver map.
+  POLYMORPHIC,
   // Multiple receiver types have been seen.
   MEGAMORPHIC,
   // Special states for debug break or step in prepare stubs.
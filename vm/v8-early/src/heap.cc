@@ -31,6 +31,7 @@
 #include "api.h"
 #include "bootstrapper.h"
 #include "codegen-inl.h"
+#include "compilation-cache.h"
 #include "debug.h"
 #include "global-handles.h"
 #include "jsregexp.h"
@@ -61,6 +62,11 @@ DEFINE_int(gc_interval, -1, "garbage collect after <n> allocations");
 DEFINE_bool(trace_gc, false,
             "print one trace line following each garbage collection");
 
+DEFINE_bool(pretenure_from_feedback, true,
+            "allocate objects from sites that survive scavenges in old space");
+DEFINE_int(pretenure_survival_percent, 85,
+           "percentage of surviving objects needed to pretenure a site");
+
 
 #ifdef ENABLE_LOGGING_AND_PROFILING
 DECLARE_bool(log_gc);
@@ -105,8 +111,10 @@ GCCallback Heap::global_gc_epilogue_callback_ = NULL;
 int Heap::young_generation_size_ = 0;  // Will be 2 * semispace_size_.
 
 // Double the new space after this many scavenge collections.
-int Heap::new_space_growth_limit_ = 8;
+static const int kInitialNewSpaceGrowthLimit = 8;
+int Heap::new_space_growth_limit_ = kInitialNewSpaceGrowthLimit;
 int Heap::scavenge_count_ = 0;
+int Heap::size_after_idle_notification_ = -1;
 Heap::HeapState Heap::gc_state_ = NOT_IN_GC;
 
 #ifdef DEBUG
@@ -465,6 +473,14 @@ void Heap::MarkCompact() {
 
 
 void Heap::MarkCompactPrologue() {
+  // Age the compilation cache, or drop it altogether if the old
+  // generation has run out of space.
+  if (old_gen_exhausted_) {
+    CompilationCache::Clear();
+  } else {
+    CompilationCache::Age();
+  }
+  AllocationSiteFeedback::Clear();
   RegExpImpl::OldSpaceCollectionPrologue();
   Top::MarkCompactPrologue();
   ThreadManager::MarkCompactPrologue();
@@ -633,6 +649,8 @@ void Heap::Scavenge() {
   // Set age mark.
   new_space_->set_age_mark(new_mark);
 
+  AllocationSiteFeedback::ProcessFeedback();
+
   LOG(ResourceEvent("scavenge", "end"));
 
   gc_state_ = NOT_IN_GC;
@@ -829,6 +847,14 @@ void Heap::CopyObject(HeapObject** p) {
     type = Map::cast(first_word)->instance_type();
   }
 
+  // Objects above the age mark survive a scavenge for the first time.
+  // Count them for the site they were allocated from.
+  if ((type == JS_OBJECT_TYPE || type == JS_ARRAY_TYPE) &&
+      object->address() >= new_space_->age_mark() &&
+      FLAG_pretenure_from_feedback) {
+    AllocationSiteFeedback::RecordSurvival(Map::cast(first_word));
+  }
+
   int object_size = object->SizeFromMap(Map::cast(first_word));
   Object* result;
   // If the object should be promoted, we try to copy it to old space.
@@ -1249,6 +1275,9 @@ bool Heap::CreateInitialObjects() {
   if (obj->IsFailure()) return false;
   natives_source_cache_ = FixedArray::cast(obj);
 
+  // Initialize the compilation cache.
+  CompilationCache::Clear();
+
   return true;
 }
 
@@ -1742,6 +1771,17 @@ Object* Heap::AllocateJSObjectFromMap(Map* map, PretenureFlag pretenure) {
   Object* properties = AllocatePropertyStorageForMap(map);
   if (properties->IsFailure()) return properties;
 
+  // Consult the allocation site unless the caller asked for old space.
+  // Objects keep their constructor across map transitions, so the
+  // constructor identifies the site when there is one.
+  if (pretenure == NOT_TENURED) {
+    Object* constructor = map->constructor();
+    HeapObject* site = constructor->IsJSFunction()
+        ? HeapObject::cast(constructor)
+        : map;
+    pretenure = AllocationSiteFeedback::RecordAllocation(site);
+  }
+
   // Allocate the JSObject.
   AllocationSpace space = (pretenure == TENURED) ? OLD_SPACE : NEW_SPACE;
   if (map->instance_size() > MaxHeapObjectSize()) space = LO_SPACE;
@@ -2419,6 +2459,8 @@ void Heap::IterateStrongRoots(ObjectVisitor* v) {
   SYNCHRONIZE_TAG("top");
   Debug::Iterate(v);
   SYNCHRONIZE_TAG("debug");
+  CompilationCache::Iterate(v);
+  SYNCHRONIZE_TAG("compilationcache");
 
   // Iterate over local handles in handle scopes.
   HandleScopeImplementer::Iterate(v);
@@ -2556,6 +2598,8 @@ bool Heap::Setup(bool create_heap_objects) {
 void Heap::TearDown() {
   GlobalHandles::TearDown();
 
+  MarkCompactCollector::TearDown();
+
   if (new_space_ != NULL) {
     new_space_->TearDown();
     delete new_space_;
@@ -2598,6 +2642,34 @@ void Heap::Shrink() {
 }
 
 
+bool Heap::IdleNotification() {
+  if (SizeOfObjects() == size_after_idle_notification_) return true;
+
+  // Compact the old generation so that its free pages end up after the
+  // allocation tops, where they can be released.
+  MarkCompactCollector::SetForceCompaction(true);
+  CollectGarbage(0, OLD_SPACE);
+  MarkCompactCollector::SetForceCompaction(false);
+
+  map_space_->Shrink(true);
+  old_space_->Shrink(true);
+  code_space_->Shrink(true);
+
+  // Shrink the new space while the surviving objects still fit and let it
+  // grow again at the normal pace once the embedder becomes active.
+  while (new_space_->Capacity() > initial_semispace_size_ &&
+         new_space_->Size() <= new_space_->Capacity() / 2) {
+    if (!new_space_->Halve()) break;
+  }
+  new_space_growth_limit_ = kInitialNewSpaceGrowthLimit;
+  scavenge_count_ = 0;
+
+  LOG(IntEvent("heap-capacity", Capacity()));
+  size_after_idle_notification_ = SizeOfObjects();
+  return false;
+}
+
+
 #ifdef DEBUG
 
 class PrintHandleVisitor: public ObjectVisitor {
@@ -2617,6 +2689,95 @@ void Heap::PrintHandles() {
 #endif
 
 
+//
+// AllocationSiteFeedback class implementation.
+//
+AllocationSiteFeedback::Entry
+    AllocationSiteFeedback::entries_[AllocationSiteFeedback::kTableSize];
+int AllocationSiteFeedback::used_ = 0;
+
+
+AllocationSiteFeedback::Entry* AllocationSiteFeedback::Lookup(
+    HeapObject* site,
+    bool insert) {
+  int index = static_cast<int>(
+      reinterpret_cast<intptr_t>(site) >> kObjectAlignmentBits);
+  for (int i = 0; i < kTableSize; i++) {
+    Entry* entry = &entries_[(index + i) & (kTableSize - 1)];
+    if (entry->site == site) return entry;
+    if (entry->site == NULL) {
+      // Keep the table sparse so probe sequences stay short.
+      if (!insert || used_ >= (kTableSize >> 1) + (kTableSize >> 2)) {
+        return NULL;
+      }
+      used_++;
+      entry->site = site;
+      entry->allocated = 0;
+      entry->survived = 0;
+      entry->pretenure = false;
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+
+PretenureFlag AllocationSiteFeedback::RecordAllocation(HeapObject* site) {
+  if (!FLAG_pretenure_from_feedback) return NOT_TENURED;
+  Entry* entry = Lookup(site, true);
+  if (entry == NULL) return NOT_TENURED;
+  if (entry->pretenure) {
+    Counters::pretenured_allocations.Increment();
+    return TENURED;
+  }
+  entry->allocated++;
+  return NOT_TENURED;
+}
+
+
+void AllocationSiteFeedback::RecordSurvival(Map* map) {
+  // Literal clones are keyed by their map, everything else by its
+  // constructor.
+  Entry* entry = Lookup(map, false);
+  if (entry == NULL) {
+    Object* constructor = map->constructor();
+    if (!constructor->IsJSFunction()) return;
+    entry = Lookup(HeapObject::cast(constructor), false);
+    if (entry == NULL) return;
+  }
+  entry->survived++;
+}
+
+
+void AllocationSiteFeedback::ProcessFeedback() {
+  if (used_ == 0) return;
+  for (int i = 0; i < kTableSize; i++) {
+    Entry* entry = &entries_[i];
+    if (entry->site == NULL || entry->pretenure) continue;
+    // Keep accumulating until the site has allocated enough objects for
+    // the survival rate to be meaningful.
+    if (entry->allocated < kMinimumAllocations) continue;
+    if (entry->survived * 100 >=
+        entry->allocated * FLAG_pretenure_survival_percent) {
+      entry->pretenure = true;
+      Counters::pretenured_sites.Increment();
+      LOG(IntEvent("pretenure-site", entry->allocated));
+    }
+    entry->allocated = 0;
+    entry->survived = 0;
+  }
+}
+
+
+void AllocationSiteFeedback::Clear() {
+  if (used_ == 0) return;
+  for (int i = 0; i < kTableSize; i++) {
+    entries_[i].site = NULL;
+  }
+  used_ = 0;
+}
+
+
 HeapIterator::HeapIterator() {
   Init();
 }
@@ -642,6 +642,13 @@ class Heap : public AllStatic {
   // Invoke Shrink on shrinkable spaces.
   static void Shrink();
 
+  // Reduces the memory footprint of an idle heap: performs a compacting
+  // collection, returns all free pages of the paged spaces to the OS and
+  // shrinks the new space back towards its initial size.  Returns true if
+  // nothing has been allocated since the last call, ie, there was nothing
+  // left to reduce.
+  static bool IdleNotification();
+
   enum HeapState { NOT_IN_GC, SCAVENGE, MARK_COMPACT };
   static inline HeapState gc_state() { return gc_state_; }
 
@@ -704,6 +711,10 @@ class Heap : public AllStatic {
   static int new_space_growth_limit_;
   static int scavenge_count_;
 
+  // Size of the objects in the heap after the last idle notification, or
+  // -1 if the heap has not been reduced.
+  static int size_after_idle_notification_;
+
   static const int kMaxMapSpaceSize = 8*MB;
 
   static NewSpace* new_space_;
@@ -1079,6 +1090,63 @@ class HeapProfiler {
 };
 #endif
 
+
+// ----------------------------------------------------------------------------
+// Allocation site feedback for pretenuring.
+//
+// Objects allocated from a site whose results almost always survive their
+// first scavenge are copied twice: once within new space and once more on
+// promotion.  AllocationSiteFeedback counts allocations and first-time
+// survivors per site between scavenges and, once a site has allocated
+// enough objects with a high enough survival rate, tells the allocator to
+// allocate its objects directly in old space.
+//
+// A site is either a constructor function (objects allocated through
+// Runtime_NewObject or AllocateJSObject keep their constructor across map
+// transitions) or the map of an object literal boilerplate (clones share
+// the boilerplate's map).  Sites are raw pointers that are not visited by
+// the GC: constructor functions and maps do not move during a scavenge, and
+// all feedback is dropped before a mark-compact collection, which may move
+// or free them.
+
+class AllocationSiteFeedback : public AllStatic {
+ public:
+  // Records an allocation from the site and returns whether the object
+  // should be pretenured.
+  static PretenureFlag RecordAllocation(HeapObject* site);
+
+  // Records that an object with the given map survived its first
+  // scavenge.  Only called by the scavenger.
+  static void RecordSurvival(Map* map);
+
+  // Updates the pretenuring decisions based on the counts gathered since
+  // the last scavenge and resets the counts.  Called after each scavenge.
+  static void ProcessFeedback();
+
+  // Drops all sites and decisions.  Called before mark-compact.
+  static void Clear();
+
+ private:
+  struct Entry {
+    HeapObject* site;
+    int allocated;
+    int survived;
+    bool pretenure;
+  };
+
+  // Returns the entry for the site, inserting it when insert is true.
+  // Returns NULL if the site is absent or the table is full.
+  static Entry* Lookup(HeapObject* site, bool insert);
+
+  // Size of the site table.  Must be a power of 2.
+  static const int kTableSize = 512;
+  // Never make a decision on fewer allocations than this.
+  static const int kMinimumAllocations = 100;
+
+  static Entry entries_[kTableSize];
+  static int used_;
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_HEAP_H_
@@ -31,6 +31,7 @@
 #include "api.h"
 #include "arguments.h"
 #include "execution.h"
+#include "hashmap.h"
 #include "ic-inl.h"
 #include "runtime.h"
 #include "stub-cache.h"
@@ -41,16 +42,21 @@ namespace v8 { namespace internal {
 DEFINE_bool(trace_ic, false, "trace inline cache state transitions");
 #endif
 DEFINE_bool(use_ic, true, "use inline caching");
+DEFINE_int(max_polymorphism, 4,
+           "maximum number of receiver maps in a polymorphic inline cache");
+DEFINE_bool(ic_stats, false,
+            "collect inline cache state transitions per call site and "
+            "print them on exit");
 DECLARE_bool(strict);
 
 
-#ifdef DEBUG
 static char TransitionMarkFromState(IC::State state) {
   switch (state) {
     case UNINITIALIZED: return '0';
     case PREMONOMORPHIC: return '0';
     case MONOMORPHIC: return '1';
     case MONOMORPHIC_PROTOTYPE_FAILURE: return '^';
+    case POLYMORPHIC: return 'P';
     case MEGAMORPHIC: return 'N';
 
     // We never see the debugger states here, because the state is
@@ -63,6 +69,8 @@ static char TransitionMarkFromState(IC::State state) {
   return 0;
 }
 
+
+#ifdef DEBUG
 void IC::TraceIC(const char* type,
                  Handle<String> name,
                  State old_state,
@@ -134,14 +142,239 @@ Address IC::OriginalCodeAddress() {
 }
 
 
+// Returns whether the map is the map of String.prototype,
+// Number.prototype or Boolean.prototype. These are value wrappers
+// whose own prototype is not a value wrapper.
+static bool IsValuePrototypeMap(Map* map) {
+  return map->instance_type() == JS_VALUE_TYPE &&
+         !map->prototype()->IsJSValue();
+}
+
+
+// Finds the receiver maps handled by a monomorphic or polymorphic
+// inline cache stub and the monomorphic stubs handling them. Monomorphic
+// stubs compare the receiver map before any other map, so the first
+// embedded map is the receiver map. Polymorphic stubs are a sequence of
+// map compares each followed by a jump to a monomorphic stub. Returns
+// the number of maps found.
+static int ExtractReceiverMaps(Code* target, Map** maps, Code** stubs) {
+  int mask = RelocInfo::kCodeTargetMask | (1 << embedded_object);
+  if (target->state() == MONOMORPHIC) {
+    // Named stubs of type NORMAL are shared between receiver maps. For
+    // keyed access they are the map specific fast elements stubs.
+    Code::Kind kind = target->kind();
+    bool keyed = kind == Code::KEYED_LOAD_IC || kind == Code::KEYED_STORE_IC;
+    if (target->type() == NORMAL && !keyed) return 0;
+    for (RelocIterator it(target, mask); !it.done(); it.next()) {
+      RelocInfo* info = it.rinfo();
+      if (info->rmode() != embedded_object) continue;
+      if (!info->target_object()->IsMap()) continue;
+      Map* map = Map::cast(info->target_object());
+      // Call stubs for string, number and boolean receivers check the
+      // type of the receiver and then the map of its prototype, so they
+      // do not have a receiver map.
+      if (kind == Code::CALL_IC && IsValuePrototypeMap(map)) return 0;
+      maps[0] = map;
+      stubs[0] = target;
+      return 1;
+    }
+    return 0;
+  }
+
+  ASSERT(target->state() == POLYMORPHIC);
+  int count = 0;
+  Map* map = NULL;
+  for (RelocIterator it(target, mask); !it.done(); it.next()) {
+    RelocInfo* info = it.rinfo();
+    if (info->rmode() == embedded_object) {
+      Object* object = info->target_object();
+      if (object->IsMap()) map = Map::cast(object);
+    } else if (map != NULL) {
+      // The code target following a map check is the stub for the map.
+      Address entry = info->target_address();
+      maps[count] = map;
+      stubs[count] = Code::cast(
+          HeapObject::FromAddress(entry - Code::kHeaderSize));
+      map = NULL;
+      count++;
+    }
+  }
+  ASSERT(count <= IC::kMaxPolymorphism);
+  return count;
+}
+
+
+// Computes the receiver maps and stubs for a polymorphic inline cache
+// that has seen the given map, replacing the stub for the map if it is
+// already handled by the target. Returns zero if the inline cache has
+// seen too many maps and should go megamorphic.
+static int CollectReceiverMaps(Code* target,
+                               Map* map,
+                               Code* stub,
+                               Map** maps,
+                               Code** stubs) {
+  int count = ExtractReceiverMaps(target, maps, stubs);
+  if (count == 0) return 0;
+  for (int i = 0; i < count; i++) {
+    if (maps[i] == map) {
+      stubs[i] = stub;
+      return count;
+    }
+  }
+  int limit = Min(FLAG_max_polymorphism, IC::kMaxPolymorphism);
+  if (count >= limit) return 0;
+  maps[count] = map;
+  stubs[count] = stub;
+  return count + 1;
+}
+
+
+// Returns whether the target of an inline cache dispatches receivers
+// with the given map to the given stub.
+static bool HandlesReceiverMap(Code* target, Map* map, Code* stub) {
+  Map* maps[IC::kMaxPolymorphism];
+  Code* stubs[IC::kMaxPolymorphism];
+  int count = ExtractReceiverMaps(target, maps, stubs);
+  for (int i = 0; i < count; i++) {
+    if (maps[i] == map) return stubs[i] == stub;
+  }
+  return false;
+}
+
+
+// Returns whether a keyed access can be handled by a fast elements
+// stub specialized to the map of the receiver.
+static bool IsFastElementAccess(Handle<Object> object, Handle<Object> key) {
+  if (!key->IsSmi() || Smi::cast(*key)->value() < 0) return false;
+  if (!object->IsJSObject()) return false;
+  // Value wrappers are excluded to make indexing into string objects
+  // work as intended.
+  if (object->IsJSValue()) return false;
+  Handle<JSObject> receiver = Handle<JSObject>::cast(object);
+  if (receiver->map()->has_indexed_interceptor()) return false;
+  return receiver->HasFastElements();
+}
+
+
+// Returns whether the target of a keyed inline cache is a fast
+// elements stub or a polymorphic stub dispatching to them.
+static bool IsFastElementStub(Code* target) {
+  if (target->state() == POLYMORPHIC) return true;
+  return target->state() == MONOMORPHIC && target->type() == NORMAL;
+}
+
+
+#ifdef DEBUG
+static void TraceElementIC(const char* type,
+                           IC::State old_state,
+                           Code* new_target) {
+  if (FLAG_trace_ic) {
+    PrintF("[%s (%c->%c) #elements]\n", type,
+           TransitionMarkFromState(old_state),
+           TransitionMarkFromState(new_target->state()));
+  }
+}
+#endif
+
+
+static const char* KindNameFromCode(Code* code) {
+  switch (code->kind()) {
+    case Code::LOAD_IC: return "load";
+    case Code::KEYED_LOAD_IC: return "keyed-load";
+    case Code::STORE_IC: return "store";
+    case Code::KEYED_STORE_IC: return "keyed-store";
+    case Code::CALL_IC: return "call";
+    default: return "ic";
+  }
+}
+
+
+// Converts a script or function name for a quoted field of an ICStats
+// record, replacing the characters that would break the record.
+static SmartPointer<char> NameToCString(Object* name) {
+  if (!name->IsString() || String::cast(name)->length() == 0) {
+    return SmartPointer<char>(StrDup(""));
+  }
+  SmartPointer<char> result = String::cast(name)->ToCString();
+  for (char* p = *result; *p != '\0'; p++) {
+    if (*p == '"' || *p == '\n' || *p == '\r') *p = '_';
+  }
+  return result;
+}
+
+
+void IC::RecordTransition(Code* new_target) {
+  Code* old_target = target();
+  State old_state = old_target->state();
+  State new_state = new_target->state();
+
+  // Count the receiver maps handled by the site. A site going
+  // megamorphic has seen one more map than its old stub handled.
+  Map* maps[kMaxPolymorphism];
+  Code* stubs[kMaxPolymorphism];
+  int count = 0;
+  if (new_state == MONOMORPHIC) {
+    count = 1;
+  } else if (new_state == POLYMORPHIC) {
+    count = ExtractReceiverMaps(new_target, maps, stubs);
+  } else if (new_state == MEGAMORPHIC) {
+    if (old_state == MONOMORPHIC) {
+      count = 2;
+    } else if (old_state == POLYMORPHIC) {
+      count = ExtractReceiverMaps(old_target, maps, stubs) + 1;
+    }
+  }
+
+  // Find the function and the source position of the call site.
+  StackFrameIterator it;
+  while (it.frame()->fp() != this->fp()) it.Advance();
+  if (!it.frame()->is_java_script()) return;
+  JavaScriptFrame* frame = JavaScriptFrame::cast(it.frame());
+  int position = frame->FindCode()->SourcePosition(frame->pc());
+  SharedFunctionInfo* shared = JSFunction::cast(frame->function())->shared();
+  Object* script = shared->script();
+  SmartPointer<char> script_name =
+      NameToCString(script->IsScript() ? Script::cast(script)->name()
+                                       : Heap::undefined_value());
+  SmartPointer<char> function_name = NameToCString(shared->name());
+
+  ICStats::Record(KindNameFromCode(new_target), *script_name, *function_name,
+                  position, old_state, new_state, count);
+}
+
+
 IC::State IC::StateFrom(Code* target, Object* receiver) {
   IC::State state = target->state();
 
-  if (state != MONOMORPHIC) return state;
+  if (state != MONOMORPHIC && state != POLYMORPHIC) return state;
   if (receiver->IsUndefined() || receiver->IsNull()) return state;
 
   Map* map = GetCodeCacheMapForObject(receiver);
 
+  if (state == POLYMORPHIC) {
+    // Keyed polymorphic stubs dispatch to fast elements stubs, which
+    // miss on out of bounds keys rather than on prototype changes.
+    Code::Kind kind = target->kind();
+    if (kind == Code::KEYED_LOAD_IC || kind == Code::KEYED_STORE_IC) {
+      return POLYMORPHIC;
+    }
+
+    // If the receiver map is handled by the polymorphic stub, the stub
+    // for it failed a prototype check. Flush the code cache for the map
+    // like in the monomorphic case below, so a fresh stub gets compiled
+    // and replaces the failing one.
+    Map* maps[kMaxPolymorphism];
+    Code* stubs[kMaxPolymorphism];
+    int count = ExtractReceiverMaps(target, maps, stubs);
+    for (int i = 0; i < count; i++) {
+      if (maps[i] == map && map->IncludedInCodeCache(stubs[i])) {
+        map->ClearCodeCache();
+        break;
+      }
+    }
+    return POLYMORPHIC;
+  }
+
   // Decide whether the inline cache failed because of changes to the
   // receiver itself or changes to one of its prototypes.
   //
@@ -365,8 +598,6 @@ void CallIC::UpdateCaches(LookupResult* lookup,
     // Set the target to the pre monomorphic stub to delay
     // setting the monomorphic state.
     code = StubCache::ComputeCallPreMonomorphic(argc);
-  } else if (state == MONOMORPHIC) {
-    code = StubCache::ComputeCallMegamorphic(argc);
   } else {
     // Compute monomorphic stub.
     switch (lookup->type()) {
@@ -412,7 +643,25 @@ void CallIC::UpdateCaches(LookupResult* lookup,
 
   // Patch the call site depending on the state of the cache.
   if (state == UNINITIALIZED || state == PREMONOMORPHIC ||
-      state == MONOMORPHIC || state == MONOMORPHIC_PROTOTYPE_FAILURE) {
+      state == MONOMORPHIC_PROTOTYPE_FAILURE) {
+    set_target(Code::cast(code));
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Dispatch on the receiver map if only a few maps have been seen.
+    Map* maps[kMaxPolymorphism];
+    Code* stubs[kMaxPolymorphism];
+    int count = 0;
+    if (object->IsJSObject()) {
+      Map* map = JSObject::cast(*object)->map();
+      count = CollectReceiverMaps(target(), map, Code::cast(code),
+                                  maps, stubs);
+    }
+    if (count == 0) {
+      code = StubCache::ComputeCallMegamorphic(argc);
+    } else if (count > 1) {
+      code = StubCache::ComputeCallPolymorphic(argc, *name, maps, stubs,
+                                               count);
+    }
+    if (code->IsFailure()) return;
     set_target(Code::cast(code));
   }
 
@@ -587,8 +836,19 @@ void LoadIC::UpdateCaches(LookupResult* lookup,
   if (state == UNINITIALIZED || state == PREMONOMORPHIC ||
       state == MONOMORPHIC_PROTOTYPE_FAILURE) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
-    set_target(megamorphic_stub());
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Dispatch on the receiver map if only a few maps have been seen.
+    Map* maps[kMaxPolymorphism];
+    Code* stubs[kMaxPolymorphism];
+    int count = CollectReceiverMaps(target(), receiver->map(),
+                                    Code::cast(code), maps, stubs);
+    if (count == 0) {
+      code = megamorphic_stub();
+    } else if (count > 1) {
+      code = StubCache::ComputeLoadPolymorphic(*name, maps, stubs, count);
+      if (code->IsFailure()) return;
+    }
+    set_target(Code::cast(code));
   }
 
 #ifdef DEBUG
@@ -703,13 +963,64 @@ Object* KeyedLoadIC::Load(State state,
   // the global object).
   bool use_ic = FLAG_use_ic && !object->IsAccessCheckNeeded();
 
-  if (use_ic) set_target(generic_stub());
+  if (use_ic) {
+    if (IsFastElementAccess(object, key)) {
+      UpdateElementCaches(state, Handle<JSObject>::cast(object));
+    } else {
+      set_target(generic_stub());
+    }
+  }
 
   // Get the property.
   return Runtime::GetObjectProperty(object, *key);
 }
 
 
+void KeyedLoadIC::UpdateElementCaches(State state, Handle<JSObject> receiver) {
+  Object* code = NULL;
+  if (state == UNINITIALIZED) {
+    // This is the first time we execute this inline cache.
+    // Set the target to the pre monomorphic stub to delay
+    // setting the monomorphic state.
+    code = pre_monomorphic_stub();
+  } else if (state == MEGAMORPHIC) {
+    code = generic_stub();
+  } else {
+    code = StubCache::ComputeKeyedLoadFastElement(*receiver);
+    if (code->IsFailure()) return;
+    if (state == MONOMORPHIC || state == POLYMORPHIC) {
+      if (IsFastElementStub(target()) &&
+          HandlesReceiverMap(target(), receiver->map(), Code::cast(code))) {
+        // Out of bounds accesses and holes miss on a map the target
+        // already handles; keep the target.
+        code = target();
+      } else {
+        // Only fast elements stubs are combined into a polymorphic
+        // stub; stubs for named keyed loads go generic as before.
+        Map* maps[kMaxPolymorphism];
+        Code* stubs[kMaxPolymorphism];
+        int count = 0;
+        if (IsFastElementStub(target())) {
+          count = CollectReceiverMaps(target(), receiver->map(),
+                                      Code::cast(code), maps, stubs);
+        }
+        if (count == 0) {
+          code = generic_stub();
+        } else if (count > 1) {
+          code = StubCache::ComputeKeyedLoadPolymorphic(maps, stubs, count);
+          if (code->IsFailure()) return;
+        }
+      }
+    }
+  }
+  set_target(Code::cast(code));
+
+#ifdef DEBUG
+  TraceElementIC("KeyedLoadIC", state, target());
+#endif
+}
+
+
 void KeyedLoadIC::UpdateCaches(LookupResult* lookup, State state,
                                Handle<Object> object, Handle<String> name) {
   ASSERT(lookup->IsLoaded());
@@ -774,7 +1085,7 @@ void KeyedLoadIC::UpdateCaches(LookupResult* lookup, State state,
   ASSERT(state != MONOMORPHIC_PROTOTYPE_FAILURE);
   if (state == UNINITIALIZED || state == PREMONOMORPHIC) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
     set_target(megamorphic_stub());
   }
 
@@ -849,10 +1160,8 @@ void StoreIC::UpdateCaches(LookupResult* lookup,
     }
     case MAP_TRANSITION: {
       if (lookup->GetAttributes() != NONE) return;
-      if (receiver->map()->unused_property_fields() == 0) return;
       HandleScope scope;
-      ASSERT(type == MAP_TRANSITION &&
-             (receiver->map()->unused_property_fields() > 0));
+      ASSERT(type == MAP_TRANSITION);
       Handle<Map> transition(lookup->GetTransitionMap());
       int index = transition->PropertyIndexFor(*name);
       code = StubCache::ComputeStoreField(*name, *receiver, index, *transition);
@@ -880,8 +1189,19 @@ void StoreIC::UpdateCaches(LookupResult* lookup,
   // Patch the call site depending on the state of the cache.
   if (state == UNINITIALIZED || state == MONOMORPHIC_PROTOTYPE_FAILURE) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
-    set_target(megamorphic_stub());
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
+    // Dispatch on the receiver map if only a few maps have been seen.
+    Map* maps[kMaxPolymorphism];
+    Code* stubs[kMaxPolymorphism];
+    int count = CollectReceiverMaps(target(), receiver->map(),
+                                    Code::cast(code), maps, stubs);
+    if (count == 0) {
+      code = megamorphic_stub();
+    } else if (count > 1) {
+      code = StubCache::ComputeStorePolymorphic(*name, maps, stubs, count);
+      if (code->IsFailure()) return;
+    }
+    set_target(Code::cast(code));
   }
 
 #ifdef DEBUG
@@ -931,13 +1251,60 @@ Object* KeyedStoreIC::Store(State state,
   // the global object).
   bool use_ic = FLAG_use_ic && !object->IsAccessCheckNeeded();
 
-  if (use_ic) set_target(generic_stub());
+  if (use_ic) {
+    if (IsFastElementAccess(object, key)) {
+      UpdateElementCaches(state, Handle<JSObject>::cast(object));
+    } else {
+      set_target(generic_stub());
+    }
+  }
 
   // Set the property.
   return Runtime::SetObjectProperty(object, key, value, NONE);
 }
 
 
+void KeyedStoreIC::UpdateElementCaches(State state,
+                                       Handle<JSObject> receiver) {
+  Object* code = NULL;
+  if (state == MEGAMORPHIC) {
+    code = generic_stub();
+  } else {
+    code = StubCache::ComputeKeyedStoreFastElement(*receiver);
+    if (code->IsFailure()) return;
+    if (state == MONOMORPHIC || state == POLYMORPHIC) {
+      if (IsFastElementStub(target()) &&
+          HandlesReceiverMap(target(), receiver->map(), Code::cast(code))) {
+        // Out of bounds accesses and holes miss on a map the target
+        // already handles; keep the target.
+        code = target();
+      } else {
+        // Only fast elements stubs are combined into a polymorphic
+        // stub; stubs for named keyed stores go generic as before.
+        Map* maps[kMaxPolymorphism];
+        Code* stubs[kMaxPolymorphism];
+        int count = 0;
+        if (IsFastElementStub(target())) {
+          count = CollectReceiverMaps(target(), receiver->map(),
+                                      Code::cast(code), maps, stubs);
+        }
+        if (count == 0) {
+          code = generic_stub();
+        } else if (count > 1) {
+          code = StubCache::ComputeKeyedStorePolymorphic(maps, stubs, count);
+          if (code->IsFailure()) return;
+        }
+      }
+    }
+  }
+  set_target(Code::cast(code));
+
+#ifdef DEBUG
+  TraceElementIC("KeyedStoreIC", state, target());
+#endif
+}
+
+
 void KeyedStoreIC::UpdateCaches(LookupResult* lookup,
                                 State state,
                                 Handle<JSObject> receiver,
@@ -969,10 +1336,8 @@ void KeyedStoreIC::UpdateCaches(LookupResult* lookup,
     }
     case MAP_TRANSITION: {
       if (lookup->GetAttributes() == NONE) {
-        if (receiver->map()->unused_property_fields() == 0) return;
         HandleScope scope;
-        ASSERT(type == MAP_TRANSITION &&
-               (receiver->map()->unused_property_fields() > 0));
+        ASSERT(type == MAP_TRANSITION);
         Handle<Map> transition(lookup->GetTransitionMap());
         int index = transition->PropertyIndexFor(*name);
         code = StubCache::ComputeKeyedStoreField(*name, *receiver,
@@ -998,7 +1363,7 @@ void KeyedStoreIC::UpdateCaches(LookupResult* lookup,
   ASSERT(state != MONOMORPHIC_PROTOTYPE_FAILURE);
   if (state == UNINITIALIZED || state == PREMONOMORPHIC) {
     set_target(Code::cast(code));
-  } else if (state == MONOMORPHIC) {
+  } else if (state == MONOMORPHIC || state == POLYMORPHIC) {
     set_target(megamorphic_stub());
   }
 
@@ -1088,6 +1453,43 @@ Object* StoreIC_Miss(Arguments args) {
 }
 
 
+// Extend storage is called from the store field stubs when a map
+// transition adds a property to an object whose properties array is
+// full. Used from stub-cache-<arch>.cc.
+Object* SharedStoreIC_ExtendStorage(Arguments args) {
+  NoHandleAllocation na;
+  ASSERT(args.length() == 4);
+
+  // Convert the parameters.
+  JSObject* object = JSObject::cast(args[0]);
+  Map* transition = Map::cast(args[1]);
+  int index = Smi::cast(args[2])->value();
+  Object* value = args[3];
+
+  // Check the object has run out of property space.
+  ASSERT(object->HasFastProperties());
+  ASSERT(object->map()->unused_property_fields() == 0);
+
+  // Expand the properties array the same way as when adding the
+  // property using the transition map in the runtime system.
+  FixedArray* old_storage = object->properties();
+  int new_unused = transition->unused_property_fields();
+  int new_size = old_storage->length() + new_unused + 1;
+  ASSERT(index < new_size);
+  Object* result = old_storage->CopySize(new_size);
+  if (result->IsFailure()) return result;
+  FixedArray* new_storage = FixedArray::cast(result);
+  new_storage->set(index, value);
+
+  // Set the new property value and do the map transition.
+  object->set_properties(new_storage);
+  object->set_map(transition);
+
+  // Return the stored value.
+  return value;
+}
+
+
 void StoreIC::GenerateInitialize(MacroAssembler* masm) {
   Generate(masm, ExternalReference(IC_Utility(kStoreIC_Miss)));
 }
@@ -1119,6 +1521,138 @@ void KeyedStoreIC::GenerateMiss(MacroAssembler* masm) {
 }
 
 
+// Statistics for a single inline cache site.
+class ICSiteStats : public Malloced {
+ public:
+  char* key;  // Comma separated kind, script, function and position.
+  char history[ICStats::kMaxHistory + 1];
+  int length;  // Length of the history.
+  int transitions;
+  int maps;  // Maximum number of receiver maps handled.
+};
+
+
+static HashMap* ic_sites = NULL;
+
+
+static bool ICSiteMatch(void* key1, void* key2) {
+  return strcmp(reinterpret_cast<char*>(key1),
+                reinterpret_cast<char*>(key2)) == 0;
+}
+
+
+static uint32_t ICSiteHash(const char* key) {
+  uint32_t hash = 0;
+  for (const char* p = key; *p != '\0'; p++) {
+    hash = 31 * hash + static_cast<uint32_t>(*p);
+  }
+  return hash;
+}
+
+
+void ICStats::Record(const char* kind,
+                     const char* script,
+                     const char* function,
+                     int position,
+                     InlineCacheState old_state,
+                     InlineCacheState new_state,
+                     int maps) {
+  if (ic_sites == NULL) ic_sites = new HashMap(&ICSiteMatch);
+
+  static const int kKeySize = 256;
+  char key[kKeySize];
+  OS::SNPrintF(key, kKeySize, "%s,\"%s\",\"%s\",%d",
+               kind, script, function, position);
+  key[kKeySize - 1] = '\0';
+
+  uint32_t hash = ICSiteHash(key);
+  HashMap::Entry* entry = ic_sites->Lookup(key, hash, false);
+  if (entry == NULL) {
+    char* site_key = StrDup(key);
+    entry = ic_sites->Lookup(site_key, hash, true);
+    ICSiteStats* site = new ICSiteStats();
+    site->key = site_key;
+    site->history[0] = TransitionMarkFromState(old_state);
+    site->history[1] = '\0';
+    site->length = 1;
+    site->transitions = 0;
+    site->maps = 0;
+    entry->value = site;
+  }
+
+  ICSiteStats* site = reinterpret_cast<ICSiteStats*>(entry->value);
+  site->transitions++;
+  if (maps > site->maps) site->maps = maps;
+  char mark = TransitionMarkFromState(new_state);
+  if (site->length < kMaxHistory && site->history[site->length - 1] != mark) {
+    site->history[site->length++] = mark;
+    site->history[site->length] = '\0';
+  }
+}
+
+
+void ICStats::Print(FILE* out) {
+  // One record per inline cache site:
+  //   ic,kind,"script","function",position,history,transitions,maps
+  if (ic_sites != NULL) {
+    for (HashMap::Entry* p = ic_sites->Start(); p != NULL;
+         p = ic_sites->Next(p)) {
+      ICSiteStats* site = reinterpret_cast<ICSiteStats*>(p->value);
+      fprintf(out, "ic,%s,%s,%d,%d\n", site->key, site->history,
+              site->transitions, site->maps);
+    }
+  }
+
+  // Compute the fan-out of the map transition tree, i.e. the number
+  // of transitions leaving each map.
+  int fanout[kMaxFanout + 1];
+  for (int i = 0; i <= kMaxFanout; i++) fanout[i] = 0;
+  int map_count = 0;
+  int transition_count = 0;
+  int max_fanout = 0;
+  HeapObjectIterator it(Heap::map_space());
+  while (it.has_next()) {
+    HeapObject* object = it.next();
+    if (!object->IsMap()) continue;
+    Map* map = Map::cast(object);
+    int transitions = 0;
+    for (DescriptorReader r(map->instance_descriptors()); !r.eos();
+         r.advance()) {
+      PropertyType type = r.type();
+      if (type == MAP_TRANSITION || type == CONSTANT_TRANSITION) {
+        transitions++;
+      }
+    }
+    map_count++;
+    transition_count += transitions;
+    if (transitions > max_fanout) max_fanout = transitions;
+    fanout[Min(transitions, static_cast<int>(kMaxFanout))]++;
+  }
+
+  //   map-transitions,maps,transitions,max-fanout
+  //   map-fanout,fanout,maps (the last bucket counts larger fan-outs)
+  fprintf(out, "map-transitions,%d,%d,%d\n",
+          map_count, transition_count, max_fanout);
+  for (int i = 0; i <= kMaxFanout; i++) {
+    if (fanout[i] > 0) fprintf(out, "map-fanout,%d,%d\n", i, fanout[i]);
+  }
+  fflush(out);
+}
+
+
+void ICStats::Reset() {
+  if (ic_sites == NULL) return;
+  for (HashMap::Entry* p = ic_sites->Start(); p != NULL;
+       p = ic_sites->Next(p)) {
+    ICSiteStats* site = reinterpret_cast<ICSiteStats*>(p->value);
+    DeleteArray(site->key);
+    delete site;
+  }
+  delete ic_sites;
+  ic_sites = NULL;
+}
+
+
 static Address IC_utilities[] = {
 #define ADDR(name) FUNCTION_ADDR(name),
     IC_UTIL_LIST(ADDR)
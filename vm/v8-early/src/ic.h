@@ -32,18 +32,21 @@
 
 namespace v8 { namespace internal {
 
+DECLARE_bool(ic_stats);
+
 // IC_UTIL_LIST defines all utility functions called from generated
 // inline caching code. The argument for the macro, ICU, is the function name.
-#define IC_UTIL_LIST(ICU)       \
-  ICU(LoadIC_Miss)              \
-  ICU(KeyedLoadIC_Miss)         \
-  ICU(CallIC_Miss)              \
-  ICU(StoreIC_Miss)             \
-  ICU(KeyedStoreIC_Miss)        \
-  /* Utilities for IC stubs. */ \
-  ICU(LoadCallbackProperty)     \
-  ICU(StoreCallbackProperty)    \
-  ICU(LoadInterceptorProperty)  \
+#define IC_UTIL_LIST(ICU)          \
+  ICU(LoadIC_Miss)                 \
+  ICU(KeyedLoadIC_Miss)            \
+  ICU(CallIC_Miss)                 \
+  ICU(StoreIC_Miss)                \
+  ICU(KeyedStoreIC_Miss)           \
+  /* Utilities for IC stubs. */    \
+  ICU(SharedStoreIC_ExtendStorage) \
+  ICU(LoadCallbackProperty)        \
+  ICU(StoreCallbackProperty)       \
+  ICU(LoadInterceptorProperty)     \
   ICU(StoreInterceptorProperty)
 
 //
@@ -100,6 +103,10 @@ class IC {
   // This method should not be called with undefined or null.
   static inline Map* GetCodeCacheMapForObject(Object* object);
 
+  // Upper bound on the number of receiver maps a polymorphic inline
+  // cache dispatches on; see --max_polymorphism.
+  static const int kMaxPolymorphism = 8;
+
  protected:
   Address fp() const { return fp_; }
   Address pc() const { return *pc_address_; }
@@ -109,7 +116,13 @@ class IC {
   Address OriginalCodeAddress();
 
   // Set the call-site target.
-  void set_target(Code* code) { SetTargetAtAddress(address(), code); }
+  void set_target(Code* code) {
+    if (FLAG_ic_stats) RecordTransition(code);
+    SetTargetAtAddress(address(), code);
+  }
+
+  // Records the state transition of the call site in ICStats.
+  void RecordTransition(Code* new_target);
 
 #ifdef DEBUG
   static void TraceIC(const char* type,
@@ -141,6 +154,38 @@ class IC {
 };
 
 
+// ICStats collects, per inline cache site, the history of state
+// transitions and the number of receiver maps the site has handled.
+// Collection is enabled by --ic_stats. The statistics are printed one
+// comma separated record per line, together with the fan-out of the
+// map transition tree.
+class ICStats : public AllStatic {
+ public:
+  // Records a state transition of the inline cache site identified
+  // by the given kind, script, function and source position.
+  static void Record(const char* kind,
+                     const char* script,
+                     const char* function,
+                     int position,
+                     InlineCacheState old_state,
+                     InlineCacheState new_state,
+                     int maps);
+
+  // Prints the collected statistics and the map transition tree
+  // fan-out.
+  static void Print(FILE* out);
+
+  // Discards the collected statistics.
+  static void Reset();
+
+  // Maximum number of states kept in the history of a site.
+  static const int kMaxHistory = 32;
+
+  // Maps with this many transitions or more share a fan-out bucket.
+  static const int kMaxFanout = 16;
+};
+
+
 // An IC_Utility encapsulates IC::UtilityId. It exists mainly because you
 // cannot make forward declarations to an enum.
 class IC_Utility {
@@ -255,6 +300,9 @@ class KeyedLoadIC: public IC {
                     Handle<Object> object,
                     Handle<String> name);
 
+  // Update the inline cache for a load of a fast element.
+  void UpdateElementCaches(State state, Handle<JSObject> receiver);
+
   // Stub accessors.
   static Code* initialize_stub() {
     return Builtins::builtin(Builtins::KeyedLoadIC_Initialize);
@@ -335,6 +383,9 @@ class KeyedStoreIC: public IC {
                     Handle<String> name,
                     Handle<Object> value);
 
+  // Update the inline cache for a store to a fast element.
+  void UpdateElementCaches(State state, Handle<JSObject> receiver);
+
   // Stub accessors.
   static Code* initialize_stub() {
     return Builtins::builtin(Builtins::KeyedStoreIC_Initialize);
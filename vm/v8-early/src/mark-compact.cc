@@ -54,6 +54,9 @@ DEFINE_bool(cleanup_ics_at_gc, true,
             "Flush inline caches prior to mark compact collection.");
 DEFINE_bool(cleanup_caches_in_maps_at_gc, true,
             "Flush code caches in maps during mark compact cycle.");
+DEFINE_bool(parallel_sweeping, true,
+            "Sweep code space and half of old space on a helper thread "
+            "during mark-sweep.");
 
 DECLARE_bool(gc_global);
 
@@ -61,6 +64,7 @@ DECLARE_bool(gc_global);
 // MarkCompactCollector
 
 bool MarkCompactCollector::compacting_collection_ = false;
+bool MarkCompactCollector::force_compaction_ = false;
 
 #ifdef DEBUG
 MarkCompactCollector::CollectorState MarkCompactCollector::state_ = IDLE;
@@ -107,7 +111,7 @@ void MarkCompactCollector::Prepare() {
 #endif
   ASSERT(!FLAG_always_compact || !FLAG_never_compact);
 
-  compacting_collection_ = FLAG_always_compact;
+  compacting_collection_ = FLAG_always_compact || force_compaction_;
 
   // We compact the old generation if it gets too fragmented (ie, we could
   // recover an expected amount of space by reclaiming the waste and free
@@ -958,56 +962,70 @@ static void SweepSpace(NewSpace* space) {
 }
 
 
-static void SweepSpace(PagedSpace* space, DeallocateFunction dealloc) {
-  PageIterator it(space, PageIterator::PAGES_IN_USE);
-  while (it.has_next()) {
-    Page* p = it.next();
+static void SweepPage(Page* p, DeallocateFunction dealloc) {
+  bool is_previous_alive = true;
+  Address free_start = NULL;
+  HeapObject* object;
 
-    bool is_previous_alive = true;
-    Address free_start = NULL;
-    HeapObject* object;
-
-    for (Address current = p->ObjectAreaStart();
-         current < p->AllocationTop();
-         current += object->Size()) {
-      object = HeapObject::FromAddress(current);
-      if (is_marked(object)) {
-        clear_mark(object);
-        if (MarkCompactCollector::IsCompacting() && object->IsCode()) {
-          // If this is compacting collection marked code objects have had
-          // their IC targets converted to objects.
-          // They need to be converted back to addresses.
-          Code::cast(object)->ConvertICTargetsFromObjectToAddress();
-        }
-        if (!is_previous_alive) {  // Transition from free to live.
-          dealloc(free_start, current - free_start);
-          is_previous_alive = true;
-        }
-      } else {
-        if (object->IsCode()) {
-          LOG(CodeDeleteEvent(Code::cast(object)->address()));
-        }
-        if (is_previous_alive) {  // Transition from live to free.
-          free_start = current;
-          is_previous_alive = false;
-        }
+  for (Address current = p->ObjectAreaStart();
+       current < p->AllocationTop();
+       current += object->Size()) {
+    object = HeapObject::FromAddress(current);
+    if (is_marked(object)) {
+      clear_mark(object);
+      if (MarkCompactCollector::IsCompacting() && object->IsCode()) {
+        // If this is compacting collection marked code objects have had
+        // their IC targets converted to objects.
+        // They need to be converted back to addresses.
+        Code::cast(object)->ConvertICTargetsFromObjectToAddress();
+      }
+      if (!is_previous_alive) {  // Transition from free to live.
+        dealloc(free_start, current - free_start);
+        is_previous_alive = true;
+      }
+    } else {
+      if (object->IsCode()) {
+        LOG(CodeDeleteEvent(Code::cast(object)->address()));
+      }
+      if (is_previous_alive) {  // Transition from live to free.
+        free_start = current;
+        is_previous_alive = false;
       }
-      // The object is now unmarked for the call to Size() at the top of the
-      // loop.
     }
+    // The object is now unmarked for the call to Size() at the top of the
+    // loop.
+  }
 
-    // If the last region was not live we need to from free_start to the
-    // allocation top in the page.
-    if (!is_previous_alive) {
-      int free_size = p->AllocationTop() - free_start;
-      if (free_size > 0) {
-        dealloc(free_start, free_size);
-      }
+  // If the last region was not live we need to from free_start to the
+  // allocation top in the page.
+  if (!is_previous_alive) {
+    int free_size = p->AllocationTop() - free_start;
+    if (free_size > 0) {
+      dealloc(free_start, free_size);
     }
   }
 }
 
 
+// Sweeps the pages in use of a paged space whose index in the space is
+// in [from, to[.
+static void SweepPages(PagedSpace* space,
+                       int from,
+                       int to,
+                       DeallocateFunction dealloc) {
+  PageIterator it(space, PageIterator::PAGES_IN_USE);
+  for (int i = 0; i < to && it.has_next(); i++) {
+    Page* p = it.next();
+    if (i >= from) SweepPage(p, dealloc);
+  }
+}
+
+
+static void SweepSpace(PagedSpace* space, DeallocateFunction dealloc) {
+  SweepPages(space, 0, kMaxInt, dealloc);
+}
+
+
 void MarkCompactCollector::DeallocateOldBlock(Address start,
                                               int size_in_bytes) {
   Heap::ClearRSetRange(start, size_in_bytes);
@@ -1066,6 +1084,99 @@ void MarkCompactCollector::EncodeForwardingAddresses() {
 }
 
 
+// The sweeper thread sweeps code space and the first pages of old space
+// while the main thread sweeps the remaining old space pages and new
+// space.  Sweeping a page only writes to that page and to a free list and
+// accounting stats.  The sweeper thread puts the old space blocks it frees
+// on its own free list, which the main thread merges into old space once
+// the sweeper is done, so the two threads never touch the same memory.
+// Both threads read (possibly non-live) maps, which is why map space is
+// swept only after the sweeper thread is done.
+class SweeperThread: public Thread {
+ public:
+  SweeperThread()
+      : start_sweeping_(OS::CreateSemaphore(0)),
+        sweeping_done_(OS::CreateSemaphore(0)),
+        stop_(false),
+        old_space_pages_(0),
+        free_list_(OLD_SPACE),
+        freed_bytes_(0),
+        wasted_bytes_(0) { }
+
+  ~SweeperThread() {
+    delete start_sweeping_;
+    delete sweeping_done_;
+  }
+
+  void Run() {
+    while (true) {
+      start_sweeping_->Wait();
+      if (stop_) return;
+      MarkCompactCollector::SweepCodeSpace();
+      SweepPages(Heap::old_space(), 0, old_space_pages_,
+                 &MarkCompactCollector::DeallocateOldBlockOnSweeperThread);
+      sweeping_done_->Signal();
+    }
+  }
+
+  // Starts sweeping code space and the given number of old space pages.
+  void StartSweeping(int old_space_pages) {
+    old_space_pages_ = old_space_pages;
+    start_sweeping_->Signal();
+  }
+
+  // Waits for the sweeper to finish and gives the old space blocks it
+  // freed to old space.
+  void WaitForSweeping() {
+    sweeping_done_->Wait();
+    Heap::old_space()->MergeFreeList(&free_list_, freed_bytes_,
+                                     wasted_bytes_);
+    freed_bytes_ = 0;
+    wasted_bytes_ = 0;
+  }
+
+  void FreeOldBlock(Address start, int size_in_bytes) {
+    wasted_bytes_ += free_list_.Free(start, size_in_bytes);
+    freed_bytes_ += size_in_bytes;
+  }
+
+  void Stop() {
+    stop_ = true;
+    start_sweeping_->Signal();
+    Join();
+  }
+
+ private:
+  Semaphore* start_sweeping_;
+  Semaphore* sweeping_done_;
+  bool stop_;
+
+  // Number of old space pages, from the first, swept by this thread.
+  int old_space_pages_;
+
+  // The blocks freed in those pages and their accounting.
+  OldSpaceFreeList free_list_;
+  int freed_bytes_;
+  int wasted_bytes_;
+};
+
+
+SweeperThread* MarkCompactCollector::sweeper_thread_ = NULL;
+
+
+void MarkCompactCollector::DeallocateOldBlockOnSweeperThread(
+    Address start,
+    int size_in_bytes) {
+  Heap::ClearRSetRange(start, size_in_bytes);
+  sweeper_thread_->FreeOldBlock(start, size_in_bytes);
+}
+
+
+void MarkCompactCollector::SweepCodeSpace() {
+  SweepSpace(Heap::code_space(), &DeallocateCodeBlock);
+}
+
+
 void MarkCompactCollector::SweepSpaces() {
   ASSERT(state_ == SWEEP_SPACES);
   ASSERT(!IsCompacting());
@@ -1074,13 +1185,43 @@ void MarkCompactCollector::SweepSpaces() {
   // the map space last because freeing non-live maps overwrites them and
   // the other spaces rely on possibly non-live maps to get the sizes for
   // non-live objects.
-  SweepSpace(Heap::old_space(), &DeallocateOldBlock);
-  SweepSpace(Heap::code_space(), &DeallocateCodeBlock);
+  if (FLAG_parallel_sweeping && sweeper_thread_ == NULL) {
+    sweeper_thread_ = new SweeperThread();
+    sweeper_thread_->Start();
+  }
+  bool parallel = FLAG_parallel_sweeping && sweeper_thread_ != NULL;
+
+  if (parallel) {
+    // Split the old space pages between the two threads.
+    int old_space_pages = 0;
+    PageIterator it(Heap::old_space(), PageIterator::PAGES_IN_USE);
+    while (it.has_next()) {
+      it.next();
+      old_space_pages++;
+    }
+    int sweeper_pages = old_space_pages / 2;
+    sweeper_thread_->StartSweeping(sweeper_pages);
+    SweepPages(Heap::old_space(), sweeper_pages, kMaxInt,
+               &DeallocateOldBlock);
+  } else {
+    SweepCodeSpace();
+    SweepSpace(Heap::old_space(), &DeallocateOldBlock);
+  }
   SweepSpace(Heap::new_space());
+  if (parallel) sweeper_thread_->WaitForSweeping();
   SweepSpace(Heap::map_space(), &DeallocateMapBlock);
 }
 
 
+void MarkCompactCollector::TearDown() {
+  if (sweeper_thread_ != NULL) {
+    sweeper_thread_->Stop();
+    delete sweeper_thread_;
+    sweeper_thread_ = NULL;
+  }
+}
+
+
 // Iterate the live objects in a range of addresses (eg, a page or a
 // semispace).  The live regions of the range have been linked into a list.
 // The first live region is [first_live_start, first_live_end), and the last
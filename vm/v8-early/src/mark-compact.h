@@ -38,6 +38,8 @@ typedef bool (*IsAliveFunction)(HeapObject* obj, int* size, int* offset);
 // Callback function for non-live blocks in the old generation.
 typedef void (*DeallocateFunction)(Address start, int size_in_bytes);
 
+class SweeperThread;
+
 
 // ----------------------------------------------------------------------------
 // Mark-Compact collector
@@ -72,12 +74,19 @@ class MarkCompactCollector : public AllStatic {
   // Performs a global garbage collection.
   static void CollectGarbage();
 
+  // Stops the sweeper thread if it has been started.
+  static void TearDown();
+
   // True if the last full GC performed heap compaction.
   static bool HasCompacted() { return compacting_collection_; }
 
   // True after the Prepare phase if the compaction is taking place.
   static bool IsCompacting() { return compacting_collection_; }
 
+  // Makes subsequent collections compact the heap regardless of its
+  // fragmentation (unless --never-compact is set).
+  static void SetForceCompaction(bool value) { force_compaction_ = value; }
+
 #ifdef DEBUG
   // Checks whether performing mark-compact collection.
   static bool in_use() { return state_ > PREPARE_GC; }
@@ -102,6 +111,9 @@ class MarkCompactCollector : public AllStatic {
   // Global flag indicating whether spaces were compacted on the last GC.
   static bool compacting_collection_;
 
+  // Global flag forcing compaction on the next GCs.
+  static bool force_compaction_;
+
   // Prepares for GC by resetting relocation info in old and map spaces and
   // choosing spaces to compact.
   static void Prepare();
@@ -201,13 +213,23 @@ class MarkCompactCollector : public AllStatic {
   // Callback functions for deallocating non-live blocks in the old
   // generation.
   static void DeallocateOldBlock(Address start, int size_in_bytes);
+  static void DeallocateOldBlockOnSweeperThread(Address start,
+                                                int size_in_bytes);
   static void DeallocateCodeBlock(Address start, int size_in_bytes);
   static void DeallocateMapBlock(Address start, int size_in_bytes);
 
   // Phase 2: If we are not compacting the heap, we simply sweep the spaces
   // except for the large object space, clearing mark bits and adding
-  // unmarked regions to each space's free list.
+  // unmarked regions to each space's free list.  With --parallel-sweeping,
+  // code space and half of the old space pages are swept on the sweeper
+  // thread at the same time.
   static void SweepSpaces();
+  static void SweepCodeSpace();
+
+  friend class SweeperThread;
+
+  // Lazily started helper thread for sweeping code space and old space.
+  static SweeperThread* sweeper_thread_;
 
 #ifdef DEBUG
   static void VerifyHeapAfterEncodingForwardingAddresses();
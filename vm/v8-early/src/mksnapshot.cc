@@ -148,6 +148,36 @@ static int WriteInternalSnapshotToFile(const char* filename,
 }
 
 
+// Compiles and runs the given JavaScript files in the current context
+// and adds them as startup scripts, so that their compiled code ends up
+// in the snapshot and is run in every context created from it.
+static bool AddStartupScripts(int count, char** files) {
+  v8::HandleScope scope;
+  for (int i = 0; i < count; i++) {
+    const char* file = files[i];
+    bool exists;
+    i::Vector<const char> source = i::ReadFile(file, &exists);
+    if (!exists) {
+      i::OS::PrintError("Cannot read startup script %s.\n", file);
+      return false;
+    }
+    // Name the script after the file without its directory, so the
+    // snapshot does not depend on where it was built.
+    const char* name = strrchr(file, '/');
+    name = (name == NULL) ? file : name + 1;
+    i::Handle<i::String> source_string = i::Factory::NewStringFromUtf8(source);
+    bool ok = i::Bootstrapper::AddStartupScript(i::CStrVector(name),
+                                                source_string);
+    i::DeleteArray(source.start());
+    if (!ok) {
+      i::OS::PrintError("Error running startup script %s.\n", file);
+      return false;
+    }
+  }
+  return true;
+}
+
+
 int main(int argc, char** argv) {
 #ifdef ENABLE_LOGGING_AND_PROFILING
   // By default, log code create information in the snapshot.
@@ -156,8 +186,8 @@ int main(int argc, char** argv) {
   // Print the usage if an error occurs when parsing the command line
   // flags or if the help flag is set.
   int result = i::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
-  if (result > 0 || argc != 2 || FLAG_h) {
-    ::printf("Usage: %s [flag] ... outfile\n", argv[0]);
+  if (result > 0 || argc < 2 || FLAG_h) {
+    ::printf("Usage: %s [flag] ... outfile [script.js] ...\n", argv[0]);
     i::FlagList::Print(NULL, false);
     return !FLAG_h;
   }
@@ -172,7 +202,13 @@ int main(int argc, char** argv) {
                                                   "v8/version",
                                                   "v8/gc" };
   v8::ExtensionConfiguration extensions(kExtensionCount, extension_list);
-  v8::Context::New(&extensions);
+  v8::Persistent<v8::Context> context = v8::Context::New(&extensions);
+
+  // Run the startup scripts given after the output file.
+  context->Enter();
+  bool scripts_ok = AddStartupScripts(argc - 2, argv + 2);
+  context->Exit();
+  if (!scripts_ok) return 1;
 
   // TODO(1247464): Cache delayed scripts.
   // Get rid of unreferenced scripts.
@@ -5291,6 +5291,10 @@ template class HashTable<0, 1>;
 template class HashTable<2, 3>;
 
 
+// Force instantiation of CompilationCacheTable's base class
+template class HashTable<0, 2>;
+
+
 Object* SymbolTable::LookupString(String* string, Object** s) {
   StringKey key(string);
   return LookupKey(&key, s);
@@ -5334,6 +5338,64 @@ Object* SymbolTable::LookupKey(Key* key, Object** s) {
 }
 
 
+// SourceKey carries the source string of a compilation as key.
+class CompilationCacheTable::SourceKey : public CompilationCacheTable::Key {
+ public:
+  explicit SourceKey(String* source) : source_(source) { }
+
+  HashFunction GetHashFunction() { return SourceHash; }
+
+  bool IsMatch(Object* other) {
+    if (!other->IsString()) return false;
+    return source_->Equals(String::cast(other));
+  }
+
+  uint32_t Hash() { return source_->Hash(); }
+
+  Object* GetObject() { return source_; }
+
+  static uint32_t SourceHash(Object* obj) {
+    return String::cast(obj)->Hash();
+  }
+
+  bool IsStringKey() { return true; }
+
+  String* source_;
+};
+
+
+Object* CompilationCacheTable::Lookup(String* src) {
+  SourceKey key(src);
+  int entry = FindEntry(&key);
+  if (entry == -1) return Heap::undefined_value();
+  return get(EntryToIndex(entry) + 1);
+}
+
+
+Object* CompilationCacheTable::Put(String* src, Object* value) {
+  SourceKey key(src);
+  int entry = FindEntry(&key);
+  if (entry != -1) {
+    set(EntryToIndex(entry) + 1, value);
+    return this;
+  }
+
+  Object* obj = EnsureCapacity(1, &key);
+  if (obj->IsFailure()) return obj;
+
+  // If the table grew as part of EnsureCapacity, obj is not the
+  // current table and therefore we cannot use
+  // CompilationCacheTable::cast here.
+  CompilationCacheTable* table =
+      reinterpret_cast<CompilationCacheTable*>(obj);
+  entry = table->FindInsertionEntry(src, key.Hash());
+  table->set(EntryToIndex(entry), src);
+  table->set(EntryToIndex(entry) + 1, value);
+  table->ElementAdded();
+  return table;
+}
+
+
 Object* Dictionary::Allocate(int at_least_space_for) {
   Object* obj = DictionaryBase::Allocate(at_least_space_for);
   // Initialize the next enumeration index.
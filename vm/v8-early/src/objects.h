@@ -55,6 +55,7 @@
 //           - HashTable
 //             - Dictionary
 //             - SymbolTable
+//             - CompilationCacheTable
 //           - Context
 //           - GlobalContext
 //       - String
@@ -612,6 +613,7 @@ class Object BASE_EMBEDDED {
   inline bool IsHashTable();
   inline bool IsDictionary();
   inline bool IsSymbolTable();
+  inline bool IsCompilationCacheTable();
   inline bool IsPrimitive();
   inline bool IsGlobalObject();
   inline bool IsJSGlobalObject();
@@ -1621,6 +1623,29 @@ class SymbolTable: public HashTable<0, 1> {
 };
 
 
+// CompilationCacheTable.
+//
+// No special elements in the prefix and the element size is 2
+// because the source string (the key) is stored together with the
+// function boilerplate compiled from it.
+class CompilationCacheTable: public HashTable<0, 2> {
+ public:
+  // Find the value for the source string, otherwise return undefined.
+  Object* Lookup(String* src);
+  // Add the value for the source string.  The return value is the
+  // table which might have been enlarged, or a failure.
+  Object* Put(String* src, Object* value);
+
+  // Casting.
+  static inline CompilationCacheTable* cast(Object* obj);
+
+ private:
+  class SourceKey;  // Key based on the source string.
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(CompilationCacheTable);
+};
+
+
 // Dictionary for keeping properties and elements in slow case.
 //
 // One element in the prefix is used for storing non-element
@@ -39,6 +39,9 @@ namespace v8 { namespace internal {
 
 DECLARE_bool(lazy);
 DEFINE_bool(allow_natives_syntax, false, "allow natives syntax");
+DEFINE_bool(preparse_lazy_functions, true,
+            "pre-parse the bodies of lazily compiled functions instead of "
+            "building their syntax trees");
 
 
 class ParserFactory;
@@ -58,6 +61,20 @@ class Parser {
   // success, false if a stack-overflow happened during parsing.
   bool PreParseProgram(unibrow::CharacterStream* stream);
 
+  // Pre-parse the program on a thread other than the V8 thread, using
+  // the given stack limit for that thread.
+  bool PreParseProgramOffThread(unibrow::CharacterStream* stream,
+                                uintptr_t stack_limit);
+
+  // Pre-parse the body of a function in source whose '{' is at
+  // brace_pos.  On success, returns true and fills in the position
+  // just after the matching '}' and the literal and property counts
+  // of the function.  Returns false on syntax errors and stack
+  // overflows.
+  bool PreParseFunctionBody(Handle<String> source, int brace_pos,
+                            int* end_pos, int* literal_count,
+                            int* property_count);
+
   void ReportMessage(const char* message, Vector<const char*> args);
   virtual void ReportMessageAt(Scanner::Location loc,
                                const char* message,
@@ -82,9 +99,21 @@ class Parser {
   // Report syntax error
   void ReportUnexpectedToken(Token::Value token);
 
+  // Skip the body of a lazily compiled function whose '{' is at
+  // brace_pos by pre-parsing it, leaving the scanner at the closing '}'.
+  // Returns false, without moving the scanner, if the body could not
+  // be pre-parsed; it must then be parsed normally to report errors.
+  bool SkipFunctionBody(int brace_pos,
+                        int* literal_count,
+                        int* property_count);
+
   Handle<Script> script_;
   Scanner scanner_;
 
+  // The source being parsed by ParseProgram.  Used for pre-parsing
+  // the bodies of lazily compiled functions.
+  Handle<String> source_;
+
   Scope* top_scope_;
   int with_nesting_level_;
 
@@ -103,6 +132,8 @@ class Parser {
   ParserLog* log() const { return log_; }
   Scanner& scanner()  { return scanner_; }
   Mode mode() const  { return mode_; }
+
+  bool PreParseSourceElements(unibrow::CharacterStream* stream);
   ScriptDataImpl* pre_data() const  { return pre_data_; }
 
   // All ParseXXX functions take as the last argument an *ok parameter
@@ -422,10 +453,50 @@ bool ScriptDataImpl::SanityCheck() {
     return false;
   if (version() != ScriptDataImpl::kCurrentVersion)
     return false;
+  if (checksum() != ComputeChecksum())
+    return false;
+  if (!has_error() &&
+      (store_.length() - kHeaderSize) % FunctionEntry::kSize != 0)
+    return false;
   return true;
 }
 
 
+unsigned ScriptDataImpl::ComputeChecksum() {
+  // The magic number, version and source hash are checked on their
+  // own, so leave them out.
+  uint32_t hash = 2166136261u;
+  hash = (hash ^ store_[kHasErrorOffset]) * 16777619u;
+  for (int i = kHeaderSize; i < store_.length(); i++) {
+    hash = (hash ^ store_[i]) * 16777619u;
+  }
+  return hash;
+}
+
+
+bool ScriptDataImpl::MatchesSource(Handle<String> source) {
+  return source_hash() == 0 || source_hash() == ComputeSourceHash(source);
+}
+
+
+unsigned ScriptDataImpl::ComputeSourceHash(Handle<String> source) {
+  // String::Hash() only covers strings up to the medium string size, so
+  // hash all the characters here (one-at-a-time hash seeded with the
+  // length).
+  uint32_t hash = source->length();
+  StringInputBuffer buffer(*source);
+  while (buffer.has_more()) {
+    hash += buffer.GetNext();
+    hash += (hash << 10);
+    hash ^= (hash >> 6);
+  }
+  hash += (hash << 3);
+  hash ^= (hash >> 11);
+  hash += (hash << 15);
+  return (hash == 0) ? 1 : hash;
+}
+
+
 int ScriptDataImpl::EntryCount() {
   return (store_.length() - kHeaderSize) / FunctionEntry::kSize;
 }
@@ -444,6 +515,8 @@ ParserRecorder::ParserRecorder()
   preamble[ScriptDataImpl::kMagicOffset] = ScriptDataImpl::kMagicNumber;
   preamble[ScriptDataImpl::kVersionOffset] = ScriptDataImpl::kCurrentVersion;
   preamble[ScriptDataImpl::kHasErrorOffset] = false;
+  preamble[ScriptDataImpl::kSourceHashOffset] = 0;
+  preamble[ScriptDataImpl::kChecksumOffset] = 0;
 }
 
 
@@ -699,6 +772,21 @@ bool Parser::PreParseProgram(unibrow::CharacterStream* stream) {
   AssertNoZoneAllocation assert_no_zone_allocation;
   AssertNoAllocation assert_no_allocation;
   NoHandleAllocation no_handle_allocation;
+  return PreParseSourceElements(stream);
+}
+
+
+bool Parser::PreParseProgramOffThread(unibrow::CharacterStream* stream,
+                                      uintptr_t stack_limit) {
+  // Pre-parsing does not use the heap, the zone or handles, so it is
+  // safe on other threads.  The checks above and the timer change
+  // state of the V8 thread and are left out.
+  scanner_.set_stack_limit(stack_limit);
+  return PreParseSourceElements(stream);
+}
+
+
+bool Parser::PreParseSourceElements(unibrow::CharacterStream* stream) {
   scanner_.Init(Handle<String>(), stream, 0);
   ASSERT(target_stack_ == NULL);
   mode_ = PARSE_EAGERLY;
@@ -712,6 +800,53 @@ bool Parser::PreParseProgram(unibrow::CharacterStream* stream) {
 }
 
 
+bool Parser::PreParseFunctionBody(Handle<String> source, int brace_pos,
+                                  int* end_pos, int* literal_count,
+                                  int* property_count) {
+  ASSERT(is_pre_parsing_);
+  // Scan a slice of the source starting at the '{' so that no time is
+  // spent on the part of the source before it.  Positions are still
+  // relative to the start of source.
+  Handle<String> rest = SubString(source, brace_pos, source->length());
+  SafeStringInputBuffer stream(rest.location());
+  scanner_.Init(rest, &stream, brace_pos);
+  ASSERT(target_stack_ == NULL);
+  mode_ = PARSE_EAGERLY;
+  DummyScope top_scope;
+  LexicalScope scope(this, &top_scope);
+  TemporaryScope temp_scope(this);
+  ZoneListWrapper<Statement> processor;
+  bool ok = true;
+  Expect(Token::LBRACE, &ok);
+  if (ok) ParseSourceElements(&processor, Token::RBRACE, &ok);
+  if (ok) Expect(Token::RBRACE, &ok);
+  if (!ok || scanner().stack_overflow()) return false;
+  *end_pos = scanner_.location().end_pos;
+  *literal_count = temp_scope.materialized_literal_count();
+  *property_count = temp_scope.expected_property_count();
+  return true;
+}
+
+
+bool Parser::SkipFunctionBody(int brace_pos,
+                              int* literal_count,
+                              int* property_count) {
+  if (!FLAG_preparse_lazy_functions || is_pre_parsing_) return false;
+  // Seeking in the scanner is only cheap for flat sources.
+  if (source_.is_null() || !source_->IsFlat()) return false;
+  HandleScope scope;
+  PreParser pre_parser(script_, allow_natives_syntax_, extension_);
+  int end_pos;
+  if (!pre_parser.PreParseFunctionBody(source_, brace_pos, &end_pos,
+                                       literal_count, property_count)) {
+    return false;
+  }
+  Counters::total_preparse_skipped.Increment(end_pos - brace_pos);
+  scanner_.SeekForward(end_pos);
+  return true;
+}
+
+
 FunctionLiteral* Parser::ParseProgram(Handle<String> source,
                                       unibrow::CharacterStream* stream,
                                       bool in_global_context) {
@@ -720,6 +855,7 @@ FunctionLiteral* Parser::ParseProgram(Handle<String> source,
 
   // Initialize parser state.
   source->TryFlatten();
+  source_ = source;
   scanner_.Init(source, stream, 0);
   ASSERT(target_stack_ == NULL);
 
@@ -2837,6 +2973,7 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> var_name,
     Expect(Token::RPAREN, CHECK_OK);
 
     Expect(Token::LBRACE, CHECK_OK);
+    int brace_pos = scanner_.location().beg_pos;
     ZoneListWrapper<Statement> body = factory()->NewList<Statement>(8);
 
     // If we have a named function expression, we add a local variable
@@ -2869,6 +3006,12 @@ FunctionLiteral* Parser::ParseFunctionLiteral(Handle<String> var_name,
       scanner_.SeekForward(end_pos);
       materialized_literal_count = entry.literal_count();
       expected_property_count = entry.property_count();
+    } else if (is_lazily_compiled &&
+               SkipFunctionBody(brace_pos,
+                                &materialized_literal_count,
+                                &expected_property_count)) {
+      // The body will be parsed by ParseLazy when the function is
+      // first called.
     } else {
       ParseSourceElements(&body, Token::RBRACE, CHECK_OK);
       materialized_literal_count = temp_scope.materialized_literal_count();
@@ -3169,7 +3312,68 @@ ScriptDataImpl* PreParse(unibrow::CharacterStream* stream,
   // That way, the result will be exactly the right size rather than
   // the expected 50% too large.
   Vector<unsigned> store = parser.recorder()->store()->ToVector().Clone();
-  return new ScriptDataImpl(store);
+  ScriptDataImpl* result = new ScriptDataImpl(store);
+  result->UpdateChecksum();
+  return result;
+}
+
+
+// The source is copied so the thread does not touch the heap. Positions
+// are counted in characters, so pre-parsing the UTF-8 copy gives the
+// same function entries as pre-parsing the string itself.
+PreCompileTaskImpl::PreCompileTaskImpl(Handle<String> source)
+    : source_(source->ToCString(ALLOW_NULLS, FAST_STRING_TRAVERSAL,
+                                &source_length_)),
+      data_(NULL),
+      joined_(false) {
+  source_hash_ = ScriptDataImpl::ComputeSourceHash(source);
+  // Make sure the scanner's static tables are set up before the
+  // thread uses them.
+  Token::Initialize();
+}
+
+
+PreCompileTaskImpl::~PreCompileTaskImpl() {
+  if (!joined_) Join();
+  delete data_;
+}
+
+
+void PreCompileTaskImpl::Run() {
+  // Leave the pre-parser this much of the thread's stack.
+  static const int kStackSize = 256 * KB;
+  uintptr_t stack_limit = reinterpret_cast<uintptr_t>(&stack_limit);
+  stack_limit -= kStackSize;
+
+  unibrow::Utf8InputBuffer<> buffer(*source_, source_length_);
+  Handle<Script> no_script;
+  PreParser parser(no_script, FLAG_allow_natives_syntax, NULL);
+  if (!parser.PreParseProgramOffThread(&buffer, stack_limit)) return;
+  Vector<unsigned> store = parser.recorder()->store()->ToVector().Clone();
+  data_ = new ScriptDataImpl(store);
+  data_->UpdateChecksum();
+}
+
+
+v8::ScriptData* PreCompileTaskImpl::Finish() {
+  if (!joined_) {
+    Join();
+    joined_ = true;
+  }
+  ScriptDataImpl* result = data_;
+  data_ = NULL;
+  if (result != NULL) result->set_source_hash(source_hash_);
+  return result;
+}
+
+
+ScriptDataImpl* PreParse(Handle<String> source, v8::Extension* extension) {
+  SafeStringInputBuffer input(source.location());
+  ScriptDataImpl* result = PreParse(&input, extension);
+  if (result != NULL) {
+    result->set_source_hash(ScriptDataImpl::ComputeSourceHash(source));
+  }
+  return result;
 }
 
 
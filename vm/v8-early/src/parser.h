@@ -85,13 +85,18 @@ class ScriptDataImpl : public ScriptData {
  public:
   explicit ScriptDataImpl(Vector<unsigned> store)
       : store_(store),
-        last_entry_(0) { }
+        last_entry_(0),
+        rejected_(false) { }
   virtual ~ScriptDataImpl();
   virtual int Length();
   virtual unsigned* Data();
+  virtual bool Rejected() { return rejected_; }
   FunctionEntry GetFunctionEnd(int start);
   bool SanityCheck();
 
+  // Called when the data is ignored by a compilation.
+  void set_rejected() { rejected_ = true; }
+
   Scanner::Location MessageLocation();
   const char* BuildMessage();
   Vector<const char*> BuildArgs();
@@ -99,15 +104,35 @@ class ScriptDataImpl : public ScriptData {
   bool has_error() { return store_[kHasErrorOffset]; }
   unsigned magic() { return store_[kMagicOffset]; }
   unsigned version() { return store_[kVersionOffset]; }
+  unsigned checksum() { return store_[kChecksumOffset]; }
+
+  // The checksum covers the error flag and everything after the
+  // header.  It is updated once the data is complete.
+  unsigned ComputeChecksum();
+  void UpdateChecksum() { store_[kChecksumOffset] = ComputeChecksum(); }
+
+  // The hash of the source the data was produced for, or zero if the
+  // data is not bound to a source.  Data bound to a source is ignored
+  // when compiling any other source.
+  unsigned source_hash() { return store_[kSourceHashOffset]; }
+  void set_source_hash(unsigned hash) { store_[kSourceHashOffset] = hash; }
+
+  // Returns true if the data can be used when compiling the source.
+  bool MatchesSource(Handle<String> source);
+
+  // Computes the source hash over all characters of the source.  Never
+  // returns zero.
+  static unsigned ComputeSourceHash(Handle<String> source);
 
   static const unsigned kMagicNumber = 0xBadDead;
-  static const unsigned kCurrentVersion = 1;
+  static const unsigned kCurrentVersion = 3;
 
   static const unsigned kMagicOffset = 0;
   static const unsigned kVersionOffset = 1;
   static const unsigned kHasErrorOffset = 2;
-  static const unsigned kSizeOffset = 3;
-  static const unsigned kHeaderSize = 4;
+  static const unsigned kSourceHashOffset = 3;
+  static const unsigned kChecksumOffset = 4;
+  static const unsigned kHeaderSize = 5;
 
  private:
   unsigned Read(int position);
@@ -121,6 +146,9 @@ class ScriptDataImpl : public ScriptData {
   // the next entry to return is typically the next entry so lookup
   // will usually be much faster if we start from the last entry.
   int last_entry_;
+
+  // Whether a compilation ignored the data.
+  bool rejected_;
 };
 
 
@@ -137,6 +165,29 @@ ScriptDataImpl* PreParse(unibrow::CharacterStream* stream,
                          v8::Extension* extension);
 
 
+// Pre-parses the source string and binds the result to it, so it can
+// be stored and used for later compilations of the same source.
+ScriptDataImpl* PreParse(Handle<String> source, v8::Extension* extension);
+
+
+// Pre-parses a copy of a source string on a separate thread.  The
+// result is bound to the source like the result of PreParse above.
+class PreCompileTaskImpl : public v8::PreCompileTask, public Thread {
+ public:
+  explicit PreCompileTaskImpl(Handle<String> source);
+  virtual ~PreCompileTaskImpl();
+  virtual void Run();
+  virtual v8::ScriptData* Finish();
+
+ private:
+  SmartPointer<char> source_;
+  int source_length_;
+  unsigned source_hash_;
+  ScriptDataImpl* data_;
+  bool joined_;
+};
+
+
 // Support for doing lazy compilation. The script is the script containing full
 // source of the script where the function is declared. The start_position and
 // end_position specifies the part of the script source which has the source
@@ -227,6 +227,7 @@ class PosixMemoryMappedFile : public OS::MemoryMappedFile {
     : file_(file), memory_(memory), size_(size) { }
   virtual ~PosixMemoryMappedFile();
   virtual void* memory() { return memory_; }
+  virtual int size() { return size_; }
  private:
   FILE* file_;
   void* memory_;
@@ -245,6 +246,23 @@ OS::MemoryMappedFile* OS::MemoryMappedFile::create(const char* name, int size,
 }
 
 
+OS::MemoryMappedFile* OS::MemoryMappedFile::open(const char* name) {
+  FILE* file = fopen(name, "rb");
+  if (file == NULL) return NULL;
+  fseek(file, 0, SEEK_END);
+  int size = ftell(file);
+  void* memory = MAP_FAILED;
+  if (size > 0) {
+    memory = mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+  }
+  if (memory == MAP_FAILED) {
+    fclose(file);
+    return NULL;
+  }
+  return new PosixMemoryMappedFile(file, memory, size);
+}
+
+
 PosixMemoryMappedFile::~PosixMemoryMappedFile() {
   if (memory_) munmap(memory_, size_);
   fclose(file_);
@@ -328,8 +346,10 @@ bool VirtualMemory::Commit(void* address, size_t size) {
 
 
 bool VirtualMemory::Uncommit(void* address, size_t size) {
+  // Map fresh inaccessible pages over the range so the old pages are
+  // returned to the OS.  Without MAP_FIXED the address is only a hint.
   return mmap(address, size, PROT_NONE,
-              MAP_PRIVATE | MAP_ANON | MAP_NORESERVE,
+              MAP_PRIVATE | MAP_ANON | MAP_NORESERVE | MAP_FIXED,
               kMmapFd, kMmapFdOffset) != MAP_FAILED;
 }
 
@@ -745,14 +745,18 @@ void OS::Abort() {
 
 class Win32MemoryMappedFile : public OS::MemoryMappedFile {
  public:
-  Win32MemoryMappedFile(HANDLE file, HANDLE file_mapping, void* memory)
-    : file_(file), file_mapping_(file_mapping), memory_(memory) { }
+  Win32MemoryMappedFile(HANDLE file, HANDLE file_mapping, void* memory,
+                        int size)
+    : file_(file), file_mapping_(file_mapping), memory_(memory),
+      size_(size) { }
   virtual ~Win32MemoryMappedFile();
   virtual void* memory() { return memory_; }
+  virtual int size() { return size_; }
  private:
   HANDLE file_;
   HANDLE file_mapping_;
   void* memory_;
+  int size_;
 };
 
 
@@ -769,7 +773,28 @@ OS::MemoryMappedFile* OS::MemoryMappedFile::create(const char* name, int size,
   // Map a view of the file into memory
   void* memory = MapViewOfFile(file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
   if (memory) memmove(memory, initial, size);
-  return new Win32MemoryMappedFile(file, file_mapping, memory);
+  return new Win32MemoryMappedFile(file, file_mapping, memory, size);
+}
+
+
+OS::MemoryMappedFile* OS::MemoryMappedFile::open(const char* name) {
+  HANDLE file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, 0, NULL);
+  if (file == INVALID_HANDLE_VALUE) return NULL;
+  int size = static_cast<int>(GetFileSize(file, NULL));
+  HANDLE file_mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0,
+                                          NULL);
+  if (file_mapping == NULL) {
+    CloseHandle(file);
+    return NULL;
+  }
+  void* memory = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (memory == NULL) {
+    CloseHandle(file_mapping);
+    CloseHandle(file);
+    return NULL;
+  }
+  return new Win32MemoryMappedFile(file, file_mapping, memory, size);
 }
 
 
@@ -187,8 +187,12 @@ class OS {
   class MemoryMappedFile {
    public:
     static MemoryMappedFile* create(const char* name, int size, void* initial);
+    // Maps an existing file read-only.  The pages are shared with other
+    // processes mapping the same file.  Returns NULL on failure.
+    static MemoryMappedFile* open(const char* name);
     virtual ~MemoryMappedFile() { }
     virtual void* memory() = 0;
+    virtual int size() = 0;
   };
 
   // Safe formatting print.
@@ -100,7 +100,10 @@ static Object* Runtime_CloneObjectLiteralBoilerplate(Arguments args) {
   CHECK(boilerplate->map()->constructor()
           ==  Top::context()->global_context()->object_function());
 #endif
-  return boilerplate->Copy();
+  // Clones share the map of their boilerplate, so the map identifies the
+  // literal site.
+  return boilerplate->Copy(
+      AllocationSiteFeedback::RecordAllocation(boilerplate->map()));
 }
 
 
@@ -885,6 +888,234 @@ static inline void ComputeKMPNextTable(String* pattern, int next_table[]) {
 }
 
 
+// Finds the contiguous characters of a flat string.  Sets either
+// *ascii_chars or *two_byte_chars, as indicated by *is_ascii, and
+// returns true; returns false if the characters are not stored in one
+// sequential or external string.  The pointers are only valid until
+// the next garbage collection.
+static bool GetFlatContent(String* str,
+                           bool* is_ascii,
+                           const uint8_t** ascii_chars,
+                           const uc16** two_byte_chars) {
+  int offset = 0;
+  if (str->IsSlicedString()) {
+    SlicedString* slice = SlicedString::cast(str);
+    offset = slice->start();
+    str = String::cast(slice->buffer());
+  }
+  if (str->IsConsString()) {
+    // A flattened cons string keeps its characters in the first part.
+    ConsString* cons = ConsString::cast(str);
+    if (String::cast(cons->second())->length() != 0) return false;
+    str = String::cast(cons->first());
+  }
+  *is_ascii = str->is_ascii();
+  if (str->IsSeqString()) {
+    if (*is_ascii) {
+      *ascii_chars = reinterpret_cast<const uint8_t*>(
+          AsciiString::cast(str)->GetCharsAddress()) + offset;
+    } else {
+      *two_byte_chars = TwoByteString::cast(str)->TwoByteStringGetData(offset);
+    }
+    return true;
+  }
+  if (str->IsExternalString()) {
+    if (*is_ascii) {
+      *ascii_chars = reinterpret_cast<const uint8_t*>(
+          ExternalAsciiString::cast(str)->resource()->data()) + offset;
+    } else {
+      *two_byte_chars =
+          ExternalTwoByteString::cast(str)->ExternalTwoByteStringGetData(
+              offset);
+    }
+    return true;
+  }
+  return false;
+}
+
+
+// Patterns shorter than this, or subjects with fewer characters than
+// this left to search, are searched without building a bad character
+// table.
+static const int kBMHMinPatternLength = 4;
+static const int kBMHMinSubjectLength = 128;
+
+// Size of the Boyer-Moore-Horspool bad character table.  Characters
+// are looked up by their low byte, so two-byte characters sharing a
+// low byte share an entry, which holds the smallest of their shifts.
+static const int kBMHAlphabetSize = 256;
+
+
+static int SingleCharIndexOf(const uint8_t* subject,
+                             int subject_length,
+                             uc16 pattern_char,
+                             int start_index) {
+  if (pattern_char > 0xff) return -1;
+  const void* found = memchr(subject + start_index, pattern_char,
+                             subject_length - start_index);
+  if (found == NULL) return -1;
+  return static_cast<const uint8_t*>(found) - subject;
+}
+
+
+static int SingleCharIndexOf(const uc16* subject,
+                             int subject_length,
+                             uc16 pattern_char,
+                             int start_index) {
+  for (int i = start_index; i < subject_length; i++) {
+    if (subject[i] == pattern_char) return i;
+  }
+  return -1;
+}
+
+
+template <typename schar, typename pchar>
+static int SimpleIndexOf(const schar* subject,
+                         int subject_length,
+                         const pchar* pattern,
+                         int pattern_length,
+                         int start_index) {
+  pchar first = pattern[0];
+  int limit = subject_length - pattern_length;
+  for (int i = start_index; i <= limit; i++) {
+    if (subject[i] != first) continue;
+    int j = 1;
+    while (j < pattern_length && pattern[j] == subject[i + j]) j++;
+    if (j == pattern_length) return i;
+  }
+  return -1;
+}
+
+
+template <typename schar, typename pchar>
+static int BoyerMooreHorspoolIndexOf(const schar* subject,
+                                     int subject_length,
+                                     const pchar* pattern,
+                                     int pattern_length,
+                                     int start_index) {
+  int last = pattern_length - 1;
+  int bad_char_shift[kBMHAlphabetSize];
+  for (int i = 0; i < kBMHAlphabetSize; i++) {
+    bad_char_shift[i] = pattern_length;
+  }
+  for (int i = 0; i < last; i++) {
+    bad_char_shift[pattern[i] & (kBMHAlphabetSize - 1)] = last - i;
+  }
+
+  pchar last_char = pattern[last];
+  int limit = subject_length - pattern_length;
+  int i = start_index;
+  while (i <= limit) {
+    schar c = subject[i + last];
+    if (c == last_char) {
+      int j = last - 1;
+      while (j >= 0 && pattern[j] == subject[i + j]) j--;
+      if (j < 0) return i;
+    }
+    i += bad_char_shift[c & (kBMHAlphabetSize - 1)];
+  }
+  return -1;
+}
+
+
+template <typename schar, typename pchar>
+static int FlatIndexOf(const schar* subject,
+                       int subject_length,
+                       const pchar* pattern,
+                       int pattern_length,
+                       int start_index) {
+  if (pattern_length == 1) {
+    return SingleCharIndexOf(subject, subject_length, pattern[0],
+                             start_index);
+  }
+  if (pattern_length < kBMHMinPatternLength ||
+      subject_length - start_index < kBMHMinSubjectLength) {
+    return SimpleIndexOf(subject, subject_length, pattern, pattern_length,
+                         start_index);
+  }
+  return BoyerMooreHorspoolIndexOf(subject, subject_length, pattern,
+                                   pattern_length, start_index);
+}
+
+
+template <typename schar, typename pchar>
+static int FlatLastIndexOf(const schar* subject,
+                           const pchar* pattern,
+                           int pattern_length,
+                           int start_index) {
+  pchar first = pattern[0];
+  for (int i = start_index; i >= 0; i--) {
+    if (subject[i] != first) continue;
+    int j = 1;
+    while (j < pattern_length && pattern[j] == subject[i + j]) j++;
+    if (j == pattern_length) return i;
+  }
+  return -1;
+}
+
+
+class IndexOfSearch BASE_EMBEDDED {
+ public:
+  IndexOfSearch(int subject_length, int pattern_length, int start_index)
+      : subject_length_(subject_length),
+        pattern_length_(pattern_length),
+        start_index_(start_index) { }
+
+  template <typename schar, typename pchar>
+  int Run(const schar* subject, const pchar* pattern) {
+    return FlatIndexOf(subject, subject_length_, pattern, pattern_length_,
+                       start_index_);
+  }
+
+ private:
+  int subject_length_;
+  int pattern_length_;
+  int start_index_;
+};
+
+
+class LastIndexOfSearch BASE_EMBEDDED {
+ public:
+  LastIndexOfSearch(int pattern_length, int start_index)
+      : pattern_length_(pattern_length),
+        start_index_(start_index) { }
+
+  template <typename schar, typename pchar>
+  int Run(const schar* subject, const pchar* pattern) {
+    return FlatLastIndexOf(subject, pattern, pattern_length_, start_index_);
+  }
+
+ private:
+  int pattern_length_;
+  int start_index_;
+};
+
+
+// Calls search->Run with the flat characters of sub and pat, each as
+// either uint8_t or uc16.  Returns false if either string is not flat.
+template <typename Search>
+static bool SearchFlatStrings(String* sub, String* pat, Search* search,
+                              int* result) {
+  bool sub_is_ascii, pat_is_ascii;
+  const uint8_t* sub_ascii = NULL;
+  const uc16* sub_two_byte = NULL;
+  const uint8_t* pat_ascii = NULL;
+  const uc16* pat_two_byte = NULL;
+  if (!GetFlatContent(sub, &sub_is_ascii, &sub_ascii, &sub_two_byte) ||
+      !GetFlatContent(pat, &pat_is_ascii, &pat_ascii, &pat_two_byte)) {
+    return false;
+  }
+  if (sub_is_ascii) {
+    *result = pat_is_ascii ? search->Run(sub_ascii, pat_ascii)
+                           : search->Run(sub_ascii, pat_two_byte);
+  } else {
+    *result = pat_is_ascii ? search->Run(sub_two_byte, pat_ascii)
+                           : search->Run(sub_two_byte, pat_two_byte);
+  }
+  return true;
+}
+
+
 static Object* Runtime_StringIndexOf(Arguments args) {
   NoHandleAllocation ha;
   ASSERT(args.length() == 3);
@@ -902,6 +1133,18 @@ static Object* Runtime_StringIndexOf(Arguments args) {
   uint32_t start_index;
   if (!Array::IndexFromObject(index, &start_index)) return Smi::FromInt(-1);
   if (pattern_length == 0) return Smi::FromInt(start_index);
+  if (pattern_length > subject_length ||
+      start_index > static_cast<uint32_t>(subject_length - pattern_length)) {
+    return Smi::FromInt(-1);
+  }
+
+  // Search the characters directly when both strings are flat, which
+  // they usually are after flattening.
+  IndexOfSearch search(subject_length, pattern_length, start_index);
+  int result;
+  if (SearchFlatStrings(sub, pat, &search, &result)) {
+    return Smi::FromInt(result);
+  }
 
   // Searching for one specific character is common.  For one
   // character patterns the KMP algorithm is guaranteed to slow down
@@ -963,9 +1206,17 @@ static Object* Runtime_StringLastIndexOf(Arguments args) {
   uint32_t pattern_length = pat->length();
   uint32_t sub_length = sub->length();
 
-  if (start_index + pattern_length > sub_length) {
+  if (pattern_length > sub_length) return Smi::FromInt(-1);
+  if (start_index > sub_length - pattern_length) {
     start_index = sub_length - pattern_length;
   }
+  if (pattern_length == 0) return Smi::FromInt(start_index);
+
+  LastIndexOfSearch search(pattern_length, start_index);
+  int result;
+  if (SearchFlatStrings(sub, pat, &search, &result)) {
+    return Smi::FromInt(result);
+  }
 
   for (int i = start_index; i >= 0; i--) {
     bool found = true;
@@ -2372,26 +2623,22 @@ static Object* Runtime_NumberCompare(Arguments args) {
 }
 
 
-static Object* Runtime_StringCompare(Arguments args) {
-  NoHandleAllocation ha;
-  ASSERT(args.length() == 2);
-
-  CONVERT_CHECKED(String, x, args[0]);
-  CONVERT_CHECKED(String, y, args[1]);
-
+// Compares two strings character by character like the < operator.
+// Does not allocate.
+static CompareResult CompareStrings(String* x, String* y) {
   // A few fast case tests before we flatten.
-  if (x == y) return Smi::FromInt(EQUAL);
+  if (x == y) return EQUAL;
   if (y->length() == 0) {
     if (x->length() == 0)
-      return Smi::FromInt(EQUAL);
-    return Smi::FromInt(GREATER);
+      return EQUAL;
+    return GREATER;
   } else if (x->length() == 0) {
-    return Smi::FromInt(LESS);
+    return LESS;
   }
   {
     int d = x->Get(0) - y->Get(0);
-    if (d < 0) return Smi::FromInt(LESS);
-    else if (d > 0) return Smi::FromInt(GREATER);
+    if (d < 0) return LESS;
+    else if (d > 0) return GREATER;
   }
 
   x->TryFlatten();
@@ -2403,14 +2650,25 @@ static Object* Runtime_StringCompare(Arguments args) {
   bufy.Reset(y);
   while (bufx.has_more() && bufy.has_more()) {
     int d = bufx.GetNext() - bufy.GetNext();
-    if (d < 0) return Smi::FromInt(LESS);
-    else if (d > 0) return Smi::FromInt(GREATER);
+    if (d < 0) return LESS;
+    else if (d > 0) return GREATER;
   }
 
   // x is (non-trivial) prefix of y:
-  if (bufy.has_more()) return Smi::FromInt(LESS);
+  if (bufy.has_more()) return LESS;
   // y is prefix of x:
-  return Smi::FromInt(bufx.has_more() ? GREATER : EQUAL);
+  return bufx.has_more() ? GREATER : EQUAL;
+}
+
+
+static Object* Runtime_StringCompare(Arguments args) {
+  NoHandleAllocation ha;
+  ASSERT(args.length() == 2);
+
+  CONVERT_CHECKED(String, x, args[0]);
+  CONVERT_CHECKED(String, y, args[1]);
+
+  return Smi::FromInt(CompareStrings(x, y));
 }
 
 
@@ -3432,6 +3690,270 @@ static Object* Runtime_GlobalPrint(Arguments args) {
 }
 
 
+// Ranges with at most this many elements are sorted by insertion sort.
+static const int kInsertionSortThreshold = 8;
+
+
+// Stable merge sort of order[from..to).  The elements of order are
+// indices into the values being sorted.
+template <typename Comparer>
+static void MergeSort(int* order, int* scratch, int from, int to,
+                      Comparer* comparer) {
+  if (to - from <= kInsertionSortThreshold) {
+    for (int i = from + 1; i < to; i++) {
+      int element = order[i];
+      int j = i;
+      while (j > from && comparer->Compare(order[j - 1], element) > 0) {
+        order[j] = order[j - 1];
+        j--;
+      }
+      order[j] = element;
+    }
+    return;
+  }
+
+  int middle = from + (to - from) / 2;
+  MergeSort(order, scratch, from, middle, comparer);
+  MergeSort(order, scratch, middle, to, comparer);
+
+  // Nothing to merge if the halves are already in order.
+  if (comparer->Compare(order[middle - 1], order[middle]) <= 0) return;
+
+  for (int i = from; i < middle; i++) scratch[i] = order[i];
+  int left = from;
+  int right = middle;
+  int target = from;
+  while (left < middle && right < to) {
+    // Take from the left half unless the right element is strictly
+    // smaller, which keeps the sort stable.
+    if (comparer->Compare(order[right], scratch[left]) < 0) {
+      order[target++] = order[right++];
+    } else {
+      order[target++] = scratch[left++];
+    }
+  }
+  while (left < middle) order[target++] = scratch[left++];
+}
+
+
+// Compares values by their string keys, as the default sort order does.
+class StringKeyComparer BASE_EMBEDDED {
+ public:
+  explicit StringKeyComparer(Handle<FixedArray> keys) : keys_(keys) { }
+
+  int Compare(int a, int b) {
+    return CompareStrings(String::cast(keys_->get(a)),
+                          String::cast(keys_->get(b)));
+  }
+
+ private:
+  Handle<FixedArray> keys_;
+};
+
+
+// Compares Smi values numerically.
+class SmiComparer BASE_EMBEDDED {
+ public:
+  SmiComparer(Handle<FixedArray> values, bool descending)
+      : values_(values), descending_(descending) { }
+
+  int Compare(int a, int b) {
+    int x = Smi::cast(values_->get(a))->value();
+    int y = Smi::cast(values_->get(b))->value();
+    if (descending_) return (x < y) - (x > y);
+    return (x > y) - (x < y);
+  }
+
+ private:
+  Handle<FixedArray> values_;
+  bool descending_;
+};
+
+
+static const char* SkipWhiteSpace(const char* p) {
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+  return p;
+}
+
+
+// Reads an identifier at p, after any white space.  Returns the
+// position after it, or NULL if there is no identifier.
+static const char* ReadIdentifier(const char* p, Vector<const char>* name) {
+  p = SkipWhiteSpace(p);
+  const char* start = p;
+  while ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') ||
+         (*p >= '0' && *p <= '9') || *p == '_' || *p == '$') {
+    p++;
+  }
+  if (p == start || (*start >= '0' && *start <= '9')) return NULL;
+  *name = Vector<const char>(start, p - start);
+  return p;
+}
+
+
+// Reads the given token at p, after any white space.  Returns the
+// position after it, or NULL if it is not there.
+static const char* ReadToken(const char* p, const char* token) {
+  if (p == NULL) return NULL;
+  p = SkipWhiteSpace(p);
+  int length = strlen(token);
+  if (strncmp(p, token, length) != 0) return NULL;
+  return p + length;
+}
+
+
+static bool NamesEqual(Vector<const char> a, Vector<const char> b) {
+  return a.length() == b.length() &&
+         strncmp(a.start(), b.start(), a.length()) == 0;
+}
+
+
+// Returns true if the function is a plain numeric comparison function,
+// 'function(a, b) { return a - b; }' or the same with 'b - a', in
+// which case *descending tells which one.  On Smis such a function is
+// free of side effects and its result only depends on the order of
+// its arguments, so the sort can compare the numbers directly.
+static bool IsNumericComparator(JSFunction* function, bool* descending) {
+  SharedFunctionInfo* shared = function->shared();
+  if (!shared->script()->IsScript()) return false;
+  Object* source = Script::cast(shared->script())->source();
+  if (!source->IsString()) return false;
+
+  // The function source starts at the parameter list.
+  static const int kMaxSourceLength = 64;
+  int start = shared->start_position();
+  int length = shared->end_position() - start;
+  if (length <= 0 || length >= kMaxSourceLength) return false;
+  char buffer[kMaxSourceLength];
+  String* string = String::cast(source);
+  for (int i = 0; i < length; i++) {
+    uc16 c = string->Get(start + i);
+    if (c == 0 || c > 127) return false;
+    buffer[i] = static_cast<char>(c);
+  }
+  buffer[length] = '\0';
+
+  Vector<const char> a = Vector<const char>::empty();
+  Vector<const char> b = Vector<const char>::empty();
+  Vector<const char> x = Vector<const char>::empty();
+  Vector<const char> y = Vector<const char>::empty();
+  const char* p = ReadToken(buffer, "(");
+  if (p != NULL) p = ReadIdentifier(p, &a);
+  p = ReadToken(p, ",");
+  if (p != NULL) p = ReadIdentifier(p, &b);
+  p = ReadToken(ReadToken(ReadToken(p, ")"), "{"), "return");
+  // 'return' must be followed by white space before the identifier.
+  if (p == NULL || SkipWhiteSpace(p) == p) return false;
+  p = ReadIdentifier(p, &x);
+  p = ReadToken(p, "-");
+  if (p != NULL) p = ReadIdentifier(p, &y);
+  if (p == NULL) return false;
+  const char* end = ReadToken(p, ";");
+  if (end != NULL) p = end;
+  p = ReadToken(p, "}");
+  if (p == NULL || *SkipWhiteSpace(p) != '\0') return false;
+
+  if (NamesEqual(a, b)) return false;
+  if (NamesEqual(x, a) && NamesEqual(y, b)) {
+    *descending = false;
+    return true;
+  }
+  if (NamesEqual(x, b) && NamesEqual(y, a)) {
+    *descending = true;
+    return true;
+  }
+  return false;
+}
+
+
+// Sorts an array with fast elements in place, as Array.prototype.sort
+// with the given comparison function or undefined.  Undefined values
+// are moved to the end.  Returns false without changing the array if
+// it is not a JSArray with fast elements and no holes, or if sorting
+// it would mean calling the comparison function, leaving the sort to
+// the JavaScript implementation.
+static Object* Runtime_SortFastElements(Arguments args) {
+  HandleScope scope;
+  ASSERT(args.length() == 2);
+
+  if (!args[0]->IsJSArray()) return Heap::false_value();
+  Handle<JSArray> array = args.at<JSArray>(0);
+  Handle<Object> comparefn = args.at<Object>(1);
+  if (!array->HasFastElements()) return Heap::false_value();
+  int length = Smi::cast(array->length())->value();
+  if (length <= 1) return Heap::true_value();
+
+  // Sort a copy of the values since converting them to strings can run
+  // code that modifies the array.
+  Handle<FixedArray> values = Factory::NewFixedArray(length);
+  int count = 0;
+  { FixedArray* elements = FixedArray::cast(array->elements());
+    for (int i = 0; i < length; i++) {
+      Object* element = elements->get(i);
+      if (element->IsTheHole()) return Heap::false_value();
+      if (!element->IsUndefined()) values->set(count++, element);
+    }
+  }
+
+  SmartPointer<int> order(NewArray<int>(count));
+  SmartPointer<int> scratch(NewArray<int>(count));
+  for (int i = 0; i < count; i++) (*order)[i] = i;
+
+  if (comparefn->IsJSFunction()) {
+    // Only comparison functions that can be replaced by comparing the
+    // numbers directly are handled here.  Calling other functions from
+    // the runtime is slower than the JavaScript sort.
+    for (int i = 0; i < count; i++) {
+      if (!values->get(i)->IsSmi()) return Heap::false_value();
+    }
+    bool descending;
+    if (!IsNumericComparator(JSFunction::cast(*comparefn), &descending)) {
+      return Heap::false_value();
+    }
+    SmiComparer comparer(values, descending);
+    MergeSort(*order, *scratch, 0, count, &comparer);
+  } else {
+    // Convert the values to strings once instead of on every
+    // comparison.
+    Handle<FixedArray> keys = Factory::NewFixedArray(count);
+    for (int i = 0; i < count; i++) {
+      Handle<Object> value(values->get(i));
+      if (!value->IsString()) {
+        bool has_pending_exception;
+        value = Execution::ToString(value, &has_pending_exception);
+        if (has_pending_exception) return Failure::Exception();
+      }
+      String::cast(*value)->TryFlatten();
+      keys->set(i, *value);
+    }
+    StringKeyComparer comparer(keys);
+    MergeSort(*order, *scratch, 0, count, &comparer);
+  }
+
+  // Store the sorted values, followed by the undefined values.  Use the
+  // generic path if the string conversions changed the array.
+  if (array->HasFastElements() &&
+      array->length() == Smi::FromInt(length) &&
+      FixedArray::cast(array->elements())->length() >= length) {
+    FixedArray* elements = FixedArray::cast(array->elements());
+    for (int i = 0; i < count; i++) {
+      elements->set(i, values->get((*order)[i]));
+    }
+    for (int i = count; i < length; i++) {
+      elements->set(i, Heap::undefined_value());
+    }
+  } else {
+    for (int i = 0; i < length; i++) {
+      Handle<Object> value = (i < count)
+          ? Handle<Object>(values->get((*order)[i]))
+          : Handle<Object>(Heap::undefined_value());
+      if (SetElement(array, i, value).is_null()) return Failure::Exception();
+    }
+  }
+  return Heap::true_value();
+}
+
+
 static Object* Runtime_RemoveArrayHoles(Arguments args) {
   ASSERT(args.length() == 1);
   // Ignore the case if this is not a JSArray.
@@ -198,6 +198,7 @@ namespace v8 { namespace internal {
   \
   /* Arrays */ \
   F(RemoveArrayHoles, 1) \
+  F(SortFastElements, 2) \
   F(GetArrayKeys, 2) \
   F(MoveArrayContents, 2) \
   F(EstimateNumberOfElements, 1) \
@@ -96,7 +96,13 @@ UTF16Buffer::UTF16Buffer()
   : pos_(0),
     pushback_buffer_(0),
     last_(0),
-    stream_(NULL) { }
+    stream_(NULL),
+    direct_access_(STREAM),
+    direct_ascii_data_(NULL),
+    direct_two_byte_data_(NULL),
+    direct_offset_(0),
+    direct_length_(0),
+    direct_pos_(0) { }
 
 
 void UTF16Buffer::Initialize(Handle<String> data,
@@ -104,6 +110,62 @@ void UTF16Buffer::Initialize(Handle<String> data,
   data_ = data;
   pos_ = 0;
   stream_ = input;
+  direct_access_ = STREAM;
+  direct_pos_ = 0;
+  // The pre-parser runs without a source string, possibly on another
+  // thread, and always reads from the stream.
+  if (!data.is_null()) InitializeDirectAccess();
+}
+
+
+void UTF16Buffer::InitializeDirectAccess() {
+  String* source = *data_;
+  int offset = 0;
+  if (source->IsSlicedString()) {
+    SlicedString* slice = SlicedString::cast(source);
+    Object* buffer = slice->buffer();
+    if (!buffer->IsString()) return;
+    offset = slice->start();
+    source = String::cast(buffer);
+  }
+  if (source->IsSeqString()) {
+    direct_access_ = source->IsAsciiString() ? SEQ_ASCII : SEQ_TWO_BYTE;
+    direct_source_ = Handle<String>(source);
+  } else if (source->IsExternalAsciiString()) {
+    direct_access_ = EXTERNAL_ASCII;
+    direct_ascii_data_ =
+        ExternalAsciiString::cast(source)->resource()->data() + offset;
+    offset = 0;
+  } else if (source->IsExternalTwoByteString()) {
+    direct_access_ = EXTERNAL_TWO_BYTE;
+    direct_two_byte_data_ =
+        ExternalTwoByteString::cast(source)->resource()->data() + offset;
+    offset = 0;
+  } else {
+    return;
+  }
+  direct_offset_ = offset;
+  direct_length_ = data_->length();
+}
+
+
+uc32 UTF16Buffer::DirectCharAt(int index) {
+  ASSERT(0 <= index && index < direct_length_);
+  switch (direct_access_) {
+    case EXTERNAL_ASCII:
+      return static_cast<unsigned char>(direct_ascii_data_[index]);
+    case EXTERNAL_TWO_BYTE:
+      return direct_two_byte_data_[index];
+    case SEQ_ASCII:
+      return AsciiString::cast(*direct_source_)->AsciiStringGet(
+          direct_offset_ + index);
+    case SEQ_TWO_BYTE:
+      return TwoByteString::cast(*direct_source_)->TwoByteStringGet(
+          direct_offset_ + index);
+    default:
+      UNREACHABLE();
+      return 0;
+  }
 }
 
 
@@ -131,6 +193,12 @@ uc32 UTF16Buffer::Advance() {
   if (!pushback_buffer()->is_empty()) {
     pos_++;
     return last_ = pushback_buffer()->RemoveLast();
+  } else if (direct_access_ != STREAM) {
+    pos_++;
+    if (direct_pos_ >= direct_length_) {
+      return last_ = static_cast<uc32>(-1);
+    }
+    return last_ = DirectCharAt(direct_pos_++);
   } else if (stream_->has_more()) {
     pos_++;
     uc32 next = stream_->GetNext();
@@ -147,14 +215,19 @@ uc32 UTF16Buffer::Advance() {
 void UTF16Buffer::SeekForward(int pos) {
   pos_ = pos;
   ASSERT(pushback_buffer()->is_empty());
-  stream_->Seek(pos);
+  if (direct_access_ != STREAM) {
+    direct_pos_ = pos;
+  } else {
+    stream_->Seek(pos);
+  }
 }
 
 
 // ----------------------------------------------------------------------------
 // Scanner
 
-Scanner::Scanner(bool pre) : stack_overflow_(false), is_pre_parsing_(pre) {
+Scanner::Scanner(bool pre)
+    : stack_overflow_(false), stack_limit_(0), is_pre_parsing_(pre) {
   Token::Initialize();
 }
 
@@ -185,13 +258,14 @@ Handle<String> Scanner::SubString(int start, int end) {
 
 
 Token::Value Scanner::Next() {
-  // BUG 1215673: Find a thread safe way to set a stack limit in
-  // pre-parse mode. Otherwise, we cannot safely pre-parse from other
-  // threads.
   current_ = next_;
-  // Check for stack-overflow before returning any tokens.
+  // Check for stack-overflow before returning any tokens. Scanners
+  // running on other threads than the V8 thread have their own limit.
   StackLimitCheck check;
-  if (check.HasOverflowed()) {
+  bool overflowed = (stack_limit_ == 0)
+      ? check.HasOverflowed()
+      : reinterpret_cast<uintptr_t>(&check) < stack_limit_;
+  if (overflowed) {
     stack_overflow_ = true;
     next_.token = Token::ILLEGAL;
   } else {
@@ -238,9 +312,9 @@ void Scanner::SkipWhiteSpace(bool initial) {
   has_line_terminator_before_next_ = initial;
 
   while (true) {
-    while (kIsWhiteSpace.get(c0_)) {
+    while (is_white_space_.get(c0_)) {
       // IsWhiteSpace() includes line terminators!
-      if (kIsLineTerminator.get(c0_))
+      if (is_line_terminator_.get(c0_))
         // Ignore line terminators, but remember them. This is necessary
         // for automatic semicolon insertion.
         has_line_terminator_before_next_ = true;
@@ -278,7 +352,7 @@ Token::Value Scanner::SkipSingleLineComment() {
   // separately by the lexical grammar and becomes part of the
   // stream of input elements for the syntactic grammar (see
   // ECMA-262, section 7.4, page 12).
-  while (c0_ >= 0 && !kIsLineTerminator.get(c0_)) {
+  while (c0_ >= 0 && !is_line_terminator_.get(c0_)) {
     Advance();
   }
 
@@ -402,7 +476,7 @@ void Scanner::ScanEscape() {
   Advance();
 
   // Skip escaped newlines.
-  if (kIsLineTerminator.get(c)) {
+  if (is_line_terminator_.get(c)) {
     // Allow CR+LF newlines in multiline string literals.
     if (IsCarriageReturn(c) && IsLineFeed(c0_)) Advance();
     // Allow LF+CR newlines in multiline string literals.
@@ -444,7 +518,7 @@ Token::Value Scanner::ScanString() {
   Advance();  // consume quote
 
   StartLiteral();
-  while (c0_ != quote && c0_ >= 0 && !kIsLineTerminator.get(c0_)) {
+  while (c0_ != quote && c0_ >= 0 && !is_line_terminator_.get(c0_)) {
     uc32 c = c0_;
     Advance();
     if (c == '\\') {
@@ -608,7 +682,7 @@ Token::Value Scanner::ScanToken() {
       return Select(Token::BIT_NOT);
 
     default:
-      if (kIsIdentifierStart.get(c0_))
+      if (is_identifier_start_.get(c0_))
         return ScanIdentifier();
       if (IsDecimalDigit(c0_))
         return ScanNumber(false);
@@ -699,7 +773,7 @@ Token::Value Scanner::ScanNumber(bool seen_period) {
   // not be an identifier start or a decimal digit; see ECMA-262
   // section 7.8.3, page 17 (note that we read only one decimal digit
   // if the value is 0).
-  if (IsDecimalDigit(c0_) || kIsIdentifierStart.get(c0_))
+  if (IsDecimalDigit(c0_) || is_identifier_start_.get(c0_))
     return Token::ILLEGAL;
 
   return Token::NUMBER;
@@ -719,7 +793,7 @@ uc32 Scanner::ScanIdentifierUnicodeEscape() {
 
 
 Token::Value Scanner::ScanIdentifier() {
-  ASSERT(kIsIdentifierStart.get(c0_));
+  ASSERT(is_identifier_start_.get(c0_));
 
   bool has_escapes = false;
 
@@ -729,18 +803,18 @@ Token::Value Scanner::ScanIdentifier() {
     has_escapes = true;
     uc32 c = ScanIdentifierUnicodeEscape();
     // Only allow legal identifier start characters.
-    if (!kIsIdentifierStart.get(c)) return Token::ILLEGAL;
+    if (!is_identifier_start_.get(c)) return Token::ILLEGAL;
     AddChar(c);
   } else {
     AddCharAdvance();
   }
   // Scan the rest of the identifier characters.
-  while (kIsIdentifierPart.get(c0_)) {
+  while (is_identifier_part_.get(c0_)) {
     if (c0_ == '\\') {
       has_escapes = true;
       uc32 c = ScanIdentifierUnicodeEscape();
       // Only allow legal identifier part characters.
-      if (!kIsIdentifierPart.get(c)) return Token::ILLEGAL;
+      if (!is_identifier_part_.get(c)) return Token::ILLEGAL;
       AddChar(c);
     } else {
       AddCharAdvance();
@@ -757,7 +831,8 @@ Token::Value Scanner::ScanIdentifier() {
   if (has_escapes)
     return Token::IDENTIFIER;
 
-  return Token::Lookup(&literals_.data()[next_.literal_pos]);
+  return Token::Lookup(&literals_.data()[next_.literal_pos],
+                       next_.literal_end - next_.literal_pos);
 }
 
 
@@ -790,11 +865,11 @@ bool Scanner::ScanRegExpPattern(bool seen_equal) {
     AddChar('=');
 
   while (c0_ != '/' || in_character_class) {
-    if (kIsLineTerminator.get(c0_) || c0_ < 0)
+    if (is_line_terminator_.get(c0_) || c0_ < 0)
       return false;
     if (c0_ == '\\') {  // escaped character
       AddCharAdvance();
-      if (kIsLineTerminator.get(c0_) || c0_ < 0)
+      if (is_line_terminator_.get(c0_) || c0_ < 0)
         return false;
       AddCharAdvance();
     } else {  // unescaped character
@@ -815,7 +890,7 @@ bool Scanner::ScanRegExpPattern(bool seen_equal) {
 bool Scanner::ScanRegExpFlags() {
   // Scan regular expression flags.
   StartLiteral();
-  while (kIsIdentifierPart.get(c0_))
+  while (is_identifier_part_.get(c0_))
     AddCharAdvance();
   TerminateLiteral();
 
@@ -67,12 +67,37 @@ class UTF16Buffer {
   void SeekForward(int pos);
 
  private:
+  // How characters are fetched from the source.  Flat sequential and
+  // external strings (and slices of them) are read directly, bypassing
+  // the UTF-8 encoding and decoding done by the character stream.
+  enum DirectAccess {
+    STREAM,              // Use stream_.
+    EXTERNAL_ASCII,      // Read from direct_ascii_data_.
+    EXTERNAL_TWO_BYTE,   // Read from direct_two_byte_data_.
+    SEQ_ASCII,           // Read from *direct_source_.
+    SEQ_TWO_BYTE         // Read from *direct_source_.
+  };
+
+  void InitializeDirectAccess();
+  inline uc32 DirectCharAt(int index);
+
   Handle<String> data_;
   int pos_;
   int size_;
   List<uc32> pushback_buffer_;
   uc32 last_;
   unibrow::CharacterStream* stream_;
+
+  // Direct access state.  Sequential strings may be moved by the
+  // garbage collector so they are accessed through a handle; external
+  // string data never moves and is cached as a raw pointer.
+  DirectAccess direct_access_;
+  Handle<String> direct_source_;
+  const char* direct_ascii_data_;
+  const uint16_t* direct_two_byte_data_;
+  int direct_offset_;
+  int direct_length_;
+  int direct_pos_;
 };
 
 
@@ -89,6 +114,11 @@ class Scanner {
             unibrow::CharacterStream* stream,
             int position);
 
+  // Sets the stack limit used to detect stack overflows when scanning
+  // on a thread other than the V8 thread.  By default the limit of the
+  // V8 thread is used.
+  void set_stack_limit(uintptr_t limit) { stack_limit_ = limit; }
+
   // Returns the next token.
   Token::Value Next();
 
@@ -160,6 +190,9 @@ class Scanner {
   // Used for checking if a property name is an identifier.
   static bool IsIdentifier(unibrow::CharacterStream* buffer);
 
+  // Looking up a character in a predicate writes to its cache, so these
+  // are only used on the V8 thread.  Scanners have their own since they
+  // can run on other threads.
   static unibrow::Predicate<IdentifierStart, 128> kIsIdentifierStart;
   static unibrow::Predicate<IdentifierPart, 128> kIsIdentifierPart;
   static unibrow::Predicate<unibrow::LineTerminator, 128> kIsLineTerminator;
@@ -170,11 +203,18 @@ class Scanner {
   UTF16Buffer source_;
   int position_;
 
+  // Character classes.
+  unibrow::Predicate<IdentifierStart, 128> is_identifier_start_;
+  unibrow::Predicate<IdentifierPart, 128> is_identifier_part_;
+  unibrow::Predicate<unibrow::LineTerminator, 128> is_line_terminator_;
+  unibrow::Predicate<unibrow::WhiteSpace, 128> is_white_space_;
+
   // Buffer to hold literal values (identifiers, strings, numbers)
   // using 0-terminated UTF-8 encoding.
   UTF8Buffer literals_;
 
   bool stack_overflow_;
+  uintptr_t stack_limit_;
   static StaticResource<Utf8Decoder> utf8_decoder_;
 
   // One Unicode character look-ahead; c0_ < 0 at the end of the input.
@@ -485,22 +485,34 @@ ExternalReferenceTable::ExternalReferenceTable() : refs_(64) {
 #undef ACCESSOR_DESCRIPTOR_DECLARATION
 
   // Stub cache tables
-  Add(SCTableReference::keyReference(StubCache::kPrimary).address(),
-      STUB_CACHE_TABLE,
-      1,
-      "StubCache::primary_->key");
-  Add(SCTableReference::valueReference(StubCache::kPrimary).address(),
-      STUB_CACHE_TABLE,
-      2,
-      "StubCache::primary_->value");
-  Add(SCTableReference::keyReference(StubCache::kSecondary).address(),
+  const char* table_format = "StubCache::%s_[%i]";
+  size_t table_format_length = strlen(table_format) + 10;
+  for (int i = 0; i < StubCache::kGroupCount; ++i) {
+    StubCache::Group group = static_cast<StubCache::Group>(i);
+    char* primary_name = NewArray<char>(table_format_length + 1);
+    OS::SNPrintF(primary_name, table_format_length, table_format,
+                 "primary", i);
+    Add(SCTableReference::tableReference(StubCache::kPrimary, group).address(),
+        STUB_CACHE_TABLE,
+        1 + 2 * i,
+        primary_name);
+    char* secondary_name = NewArray<char>(table_format_length + 1);
+    OS::SNPrintF(secondary_name, table_format_length, table_format,
+                 "secondary", i);
+    Add(SCTableReference::tableReference(StubCache::kSecondary,
+                                         group).address(),
+        STUB_CACHE_TABLE,
+        2 + 2 * i,
+        secondary_name);
+  }
+  Add(SCTableReference::maskReference(StubCache::kPrimary).address(),
       STUB_CACHE_TABLE,
-      3,
-      "StubCache::secondary_->key");
-  Add(SCTableReference::valueReference(StubCache::kSecondary).address(),
+      1 + 2 * StubCache::kGroupCount,
+      "StubCache::primary_mask_");
+  Add(SCTableReference::maskReference(StubCache::kSecondary).address(),
       STUB_CACHE_TABLE,
-      4,
-      "StubCache::secondary_->value");
+      2 + 2 * StubCache::kGroupCount,
+      "StubCache::secondary_mask_");
 
   // Runtime entries
   Add(FUNCTION_ADDR(Runtime::PerformGC),
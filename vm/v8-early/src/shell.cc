@@ -1,8 +1,418 @@
-#include <cstdio>
+// Copyright 2006-2008 Google Inc. All Rights Reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-int main(int argc, char *argv[]) {
-  printf("Hello shell!\n");
-  return 0;
+// A shell that runs JavaScript files.  The scripts can use the print,
+// load, quit, version and gc extensions.
+//
+// With --cache-dir the pre-parse data of each script is stored in the
+// given directory and reused the next time the script is run.
+//
+// With --stats the time spent compiling and running each file is
+// reported, together with the parse, lazy compilation and GC times
+// recorded by the V8 counters.  With --iterations=n each file is run
+// as a benchmark instead: --warmup untimed runs followed by n timed
+// runs, each in a fresh context.  --json prints the results as JSON;
+// exceptions and the output of print then go to stderr instead.
+
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+#include "v8.h"
+
+#include "platform.h"
+
+DEFINE_string(cache_dir, NULL, "directory for cached pre-parse data");
+DEFINE_bool(stats, false, "report compile, run and GC times for each file");
+DEFINE_int(iterations, 0, "run each file this many times as a benchmark");
+DEFINE_int(warmup, 3, "untimed runs of each file before a benchmark");
+DEFINE_bool(json, false, "print the times as JSON");
+DEFINE_bool(h, false, "print this message");
+
+// use explicit namespace to avoid clashing with types in namespace v8
+namespace i = v8::internal;
+using namespace v8;
+
+
+typedef std::map<std::wstring, int> CounterMap;
+static CounterMap counter_table_;
+
+// Callback receiver when v8 has a counter to track.  Map nodes never
+// move, so the address of a counter stays valid.
+static int* counter_callback(const wchar_t* name) {
+  return &counter_table_[name];
+}
+
+
+static int CounterValue(const wchar_t* name) {
+  CounterMap::iterator it = counter_table_.find(name);
+  return (it == counter_table_.end()) ? 0 : it->second;
+}
+
+
+// The times, in milliseconds, spent running a file.  Compile and run
+// times are measured by the shell; the rest come from the V8 counters,
+// which only have millisecond resolution per event, and are part of
+// the compile and run times.
+struct Timings {
+  double compile;
+  double run;
+  int parse;
+  int lazy_compile;
+  int gc;
+  int gc_count;
+};
+
+
+// Reads the counter based times accumulated so far.
+static void ReadCounters(Timings* timings) {
+  timings->parse = CounterValue(L"t:V8.Parse") +
+                   CounterValue(L"t:V8.ParseLazy") +
+                   CounterValue(L"t:V8.PreParse");
+  timings->lazy_compile = CounterValue(L"t:V8.CompileLazy");
+  timings->gc = CounterValue(L"t:V8.GCScavenger") +
+                CounterValue(L"t:V8.GCCompactor");
+  timings->gc_count = CounterValue(L"c:V8.GCScavenger") +
+                      CounterValue(L"c:V8.GCCompactor");
 }
 
 
+// Summary of the timings of one or more runs of a file.
+class Stats {
+ public:
+  Stats() : count_(0) { }
+
+  void Add(const Timings& timings) {
+    double total = timings.compile + timings.run;
+    if (count_ == 0) {
+      min_ = timings;
+      max_ = timings;
+      sum_ = timings;
+      min_total_ = max_total_ = sum_total_ = total;
+    } else {
+      min_.compile = Min(min_.compile, timings.compile);
+      min_.run = Min(min_.run, timings.run);
+      max_.compile = Max(max_.compile, timings.compile);
+      max_.run = Max(max_.run, timings.run);
+      min_total_ = Min(min_total_, total);
+      max_total_ = Max(max_total_, total);
+      sum_.compile += timings.compile;
+      sum_.run += timings.run;
+      sum_.parse += timings.parse;
+      sum_.lazy_compile += timings.lazy_compile;
+      sum_.gc += timings.gc;
+      sum_.gc_count += timings.gc_count;
+      sum_total_ += total;
+    }
+    count_++;
+  }
+
+  void Print(const char* file_name, bool first) {
+    if (FLAG_json) {
+      ::printf("%s\n    {\"file\": ", first ? "" : ",");
+      PrintJsonString(file_name);
+      ::printf(", \"runs\": %d,\n", count_);
+      PrintJsonRange("compile_ms", min_.compile, sum_.compile, max_.compile);
+      ::printf(",\n");
+      PrintJsonRange("run_ms", min_.run, sum_.run, max_.run);
+      ::printf(",\n");
+      PrintJsonRange("total_ms", min_total_, sum_total_, max_total_);
+      ::printf(",\n     \"parse_ms\": %.3f, \"lazy_compile_ms\": %.3f,"
+               " \"gc_ms\": %.3f, \"gc_count\": %.3f}",
+               Mean(sum_.parse), Mean(sum_.lazy_compile), Mean(sum_.gc),
+               Mean(sum_.gc_count));
+    } else {
+      ::printf("%s (%d run%s):\n", file_name, count_, count_ == 1 ? "" : "s");
+      PrintRange("compile", min_.compile, sum_.compile, max_.compile);
+      PrintRange("run", min_.run, sum_.run, max_.run);
+      PrintRange("total", min_total_, sum_total_, max_total_);
+      ::printf("  parse %.3f ms, lazy compile %.3f ms, gc %.3f ms"
+               " (%.1f collections)\n",
+               Mean(sum_.parse), Mean(sum_.lazy_compile), Mean(sum_.gc),
+               Mean(sum_.gc_count));
+    }
+  }
+
+ private:
+  static double Min(double a, double b) { return a < b ? a : b; }
+  static double Max(double a, double b) { return a > b ? a : b; }
+  double Mean(double sum) { return sum / count_; }
+
+  void PrintRange(const char* name, double min, double sum, double max) {
+    ::printf("  %-8s %10.3f ms (min %.3f, max %.3f)\n",
+             name, Mean(sum), min, max);
+  }
+
+  void PrintJsonRange(const char* name, double min, double sum, double max) {
+    ::printf("     \"%s\": {\"min\": %.3f, \"mean\": %.3f, \"max\": %.3f}",
+             name, min, Mean(sum), max);
+  }
+
+  static void PrintJsonString(const char* str) {
+    ::printf("\"");
+    for (const char* p = str; *p; p++) {
+      if (*p == '"' || *p == '\\') {
+        ::printf("\\%c", *p);
+      } else if (static_cast<unsigned char>(*p) < ' ') {
+        ::printf("\\u%04x", *p);
+      } else {
+        ::printf("%c", *p);
+      }
+    }
+    ::printf("\"");
+  }
+
+  int count_;
+  Timings min_;
+  Timings max_;
+  Timings sum_;
+  double min_total_;
+  double max_total_;
+  double sum_total_;
+};
+
+
+// Returns the name of the cache file for the script in the cache
+// directory.  The path of the script is flattened into a single file
+// name.  The result must be freed with DeleteArray.
+static char* CacheFileName(const char* file_name) {
+  static const char* kSuffix = ".cache";
+  int dir_length = strlen(FLAG_cache_dir);
+  int length = dir_length + 1 + strlen(file_name) + strlen(kSuffix) + 1;
+  char* result = i::NewArray<char>(length);
+  i::OS::SNPrintF(result, length, "%s/%s%s",
+                  FLAG_cache_dir, file_name, kSuffix);
+  for (char* p = result + dir_length + 1; *p; p++) {
+    if (*p == '/' || *p == '\\' || *p == ':') *p = '_';
+  }
+  return result;
+}
+
+
+// Compiles the source, using the cached pre-parse data for the file if
+// there is a cache directory.  The cache file is written when it is
+// missing or the compiler rejected its contents.
+static Local<Script> CompileWithCache(Handle<String> source,
+                                      ScriptOrigin* origin,
+                                      const char* file_name) {
+  if (FLAG_cache_dir == NULL) return Script::Compile(source, origin);
+
+  char* cache_file_name = CacheFileName(file_name);
+  int size = 0;
+  char* bytes = i::ReadChars(cache_file_name, &size, false);
+  if (bytes != NULL) {
+    ScriptData* cached_data = ScriptData::New(bytes, size);
+    i::DeleteArray(bytes);
+    Local<Script> result = Script::Compile(source, origin, cached_data);
+    bool rejected = cached_data->Rejected();
+    delete cached_data;
+    if (!rejected) {
+      i::DeleteArray(cache_file_name);
+      return result;
+    }
+  }
+
+  ScriptData* cached_data = ScriptData::PreCompile(source);
+  Local<Script> result = Script::Compile(source, origin, cached_data);
+  if (cached_data != NULL) {
+    i::WriteChars(cache_file_name,
+                  reinterpret_cast<const char*>(cached_data->Data()),
+                  cached_data->Length() * sizeof(unsigned),
+                  false);
+    delete cached_data;
+  }
+  i::DeleteArray(cache_file_name);
+  return result;
+}
+
+
+// Returns the stream for script output and diagnostics.  In JSON mode
+// stdout only carries the JSON results.
+static FILE* OutputStream() {
+  return FLAG_json ? stderr : stdout;
+}
+
+
+static void ReportException(TryCatch* try_catch) {
+  String::AsciiValue exception(try_catch->Exception());
+  ::fprintf(OutputStream(), "%s\n", *exception);
+}
+
+
+// Replaces the print extension in JSON mode.  Works like it but writes
+// to OutputStream().
+static Handle<Value> Print(const Arguments& args) {
+  FILE* out = OutputStream();
+  for (int i = 0; i < args.Length(); i++) {
+    if (i != 0) ::fprintf(out, " ");
+    HandleScope scope;
+    Handle<String> string_obj = args[i]->ToString();
+    if (string_obj.IsEmpty()) return string_obj;
+    int length = string_obj->Length();
+    uint16_t* string = i::NewArray<uint16_t>(length + 1);
+    string_obj->Write(string);
+    for (int j = 0; j < length; j++)
+      ::fprintf(out, "%lc", string[j]);
+    i::DeleteArray(string);
+  }
+  ::fprintf(out, "\n");
+  return Undefined();
+}
+
+
+// Runs the script in the file in the current context.  Returns false if
+// the file could not be read or the script threw an exception.  If
+// timings is not NULL the times spent running the file are stored in
+// it.
+static bool RunFile(const char* file_name, Timings* timings) {
+  HandleScope scope;
+  int size = 0;
+  char* chars = i::ReadChars(file_name, &size);
+  if (chars == NULL) return false;
+  Handle<String> source = String::New(chars, size);
+  i::DeleteArray(chars);
+
+  Timings before;
+  ReadCounters(&before);
+  double start = i::OS::TimeCurrentMillis();
+
+  ScriptOrigin origin(String::New(file_name));
+  TryCatch try_catch;
+  Local<Script> script = CompileWithCache(source, &origin, file_name);
+  if (script.IsEmpty()) {
+    ReportException(&try_catch);
+    return false;
+  }
+  double compiled = i::OS::TimeCurrentMillis();
+  script->Run();
+  if (try_catch.HasCaught()) {
+    ReportException(&try_catch);
+    return false;
+  }
+  double end = i::OS::TimeCurrentMillis();
+
+  if (timings != NULL) {
+    ReadCounters(timings);
+    timings->compile = compiled - start;
+    timings->run = end - compiled;
+    timings->parse -= before.parse;
+    timings->lazy_compile -= before.lazy_compile;
+    timings->gc -= before.gc;
+    timings->gc_count -= before.gc_count;
+  }
+  return true;
+}
+
+
+static Persistent<Context> CreateShellContext() {
+  const int kExtensionCount = 5;
+  const char* extension_list[kExtensionCount] = { "v8/load",
+                                                  "v8/quit",
+                                                  "v8/version",
+                                                  "v8/gc",
+                                                  "v8/print" };
+  if (!FLAG_json) {
+    ExtensionConfiguration extensions(kExtensionCount, extension_list);
+    return Context::New(&extensions);
+  }
+  // Leave out the print extension and install the shell's own print.
+  ExtensionConfiguration extensions(kExtensionCount - 1, extension_list);
+  HandleScope scope;
+  Handle<ObjectTemplate> global = ObjectTemplate::New();
+  global->Set(String::New("print"), FunctionTemplate::New(Print));
+  return Context::New(&extensions, global);
+}
+
+
+// Runs the file FLAG_warmup times and then FLAG_iterations times while
+// collecting timings, each time in a new context.  The compilation
+// cache is shared by the contexts, so the timed runs usually do not
+// compile the script itself.
+static bool RunBenchmark(const char* file_name, Stats* stats) {
+  for (int run = 0; run < FLAG_warmup + FLAG_iterations; run++) {
+    HandleScope scope;
+    Persistent<Context> context = CreateShellContext();
+    bool ok;
+    { Context::Scope context_scope(context);
+      Timings timings;
+      ok = RunFile(file_name, &timings);
+      if (ok && run >= FLAG_warmup) stats->Add(timings);
+    }
+    context.Dispose();
+    if (!ok) return false;
+  }
+  return true;
+}
+
+
+int main(int argc, char** argv) {
+  // Print the usage if an error occurs when parsing the command line
+  // flags or if the help flag is set.
+  int result = i::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (result > 0 || argc < 2 || FLAG_h) {
+    ::printf("Usage: %s [flag] ... file ...\n", argv[0]);
+    i::FlagList::Print(NULL, false);
+    return !FLAG_h;
+  }
+
+  // The counters must be hooked up before V8 is initialized.
+  V8::SetCounterFunction(counter_callback);
+
+  bool benchmark = FLAG_iterations > 0;
+  bool report = benchmark || FLAG_stats || FLAG_json;
+  if (FLAG_warmup < 0) FLAG_warmup = 0;
+
+  HandleScope scope;
+  Persistent<Context> context = CreateShellContext();
+  Context::Scope context_scope(context);
+
+  if (FLAG_json) {
+    ::printf("{\"iterations\": %d, \"warmup\": %d, \"results\": [",
+             benchmark ? FLAG_iterations : 1, benchmark ? FLAG_warmup : 0);
+  }
+  int status = 0;
+  for (int arg = 1; arg < argc; arg++) {
+    Stats stats;
+    bool ok;
+    if (benchmark) {
+      ok = RunBenchmark(argv[arg], &stats);
+    } else {
+      Timings timings;
+      ok = RunFile(argv[arg], &timings);
+      if (ok) stats.Add(timings);
+    }
+    if (!ok) {
+      status = 1;
+      break;
+    }
+    if (report) stats.Print(argv[arg], arg == 1);
+  }
+  if (FLAG_json) ::printf("\n]}\n");
+  context.Dispose();
+  return status;
+}
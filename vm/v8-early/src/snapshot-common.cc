@@ -44,11 +44,15 @@ bool Snapshot::Deserialize(const char* content, int len) {
 
 bool Snapshot::Initialize(const char* snapshot_file) {
   if (snapshot_file) {
-    int len;
-    char* str = ReadChars(snapshot_file, &len);
-    if (!str) return false;
-    bool result = Deserialize(str, len);
-    DeleteArray(str);
+    // Map the file instead of reading it so the deserializer reads
+    // straight from the page cache, which is shared between processes,
+    // and no private copy of the snapshot is ever made.
+    OS::MemoryMappedFile* file = OS::MemoryMappedFile::open(snapshot_file);
+    if (file == NULL) return false;
+    bool result =
+        Deserialize(reinterpret_cast<const char*>(file->memory()),
+                    file->size());
+    delete file;
     return result;
   } else if (size_ > 0) {
     return Deserialize(data_, size_);
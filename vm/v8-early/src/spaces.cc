@@ -417,6 +417,20 @@ bool MemoryAllocator::CommitBlock(Address start, size_t size) {
 }
 
 
+bool MemoryAllocator::UncommitBlock(Address start, size_t size) {
+  ASSERT(start != NULL);
+  ASSERT(size > 0);
+  ASSERT(initial_chunk_ != NULL);
+  ASSERT(initial_chunk_->address() <= start);
+  ASSERT(start + size <= reinterpret_cast<Address>(initial_chunk_->address())
+                             + initial_chunk_->size());
+
+  if (!initial_chunk_->Uncommit(start, size)) return false;
+  Counters::memory_allocated.Decrement(size);
+  return true;
+}
+
+
 Page* MemoryAllocator::InitializePagesInChunk(int chunk_id, int pages_in_chunk,
                                               PagedSpace* owner) {
   ASSERT(IsValidChunk(chunk_id));
@@ -741,8 +755,8 @@ int PagedSpace::CountTotalPages() {
 #endif
 
 
-void PagedSpace::Shrink() {
-  // Release half of free pages.
+void PagedSpace::Shrink(bool release_all) {
+  // Release half of free pages, or all of them.
   Page* top_page = AllocationTopPage();
   ASSERT(top_page->is_valid());
 
@@ -755,7 +769,7 @@ void PagedSpace::Shrink() {
   // Loop over the pages to the end of the space.
   while (current_page->is_valid()) {
     // Keep every odd-numbered page, one page for every two in the space.
-    if ((free_pages & 0x1) == 1) {
+    if (!release_all && (free_pages & 0x1) == 1) {
       pages_to_keep++;
       last_page_to_keep = last_page_to_keep->next_page();
     }
@@ -918,6 +932,18 @@ bool NewSpace::Double() {
 }
 
 
+bool NewSpace::Halve() {
+  ASSERT(Size() <= capacity_ / 2);
+  // The semispaces are halved in the same order as they are doubled so a
+  // failure leaves them with different sizes in the same way.
+  if (!to_space_->Halve() || !from_space_->Halve()) return false;
+  capacity_ /= 2;
+  allocation_info_.limit = to_space_->high();
+  ASSERT_SEMISPACE_ALLOCATION_INFO(allocation_info_, to_space_);
+  return true;
+}
+
+
 void NewSpace::ResetAllocationInfo() {
   allocation_info_.top = to_space_->low();
   allocation_info_.limit = to_space_->high();
@@ -1017,6 +1043,15 @@ bool SemiSpace::Double() {
 }
 
 
+bool SemiSpace::Halve() {
+  int half = capacity_ / 2;
+  if (!MemoryAllocator::UncommitBlock(low() + half, half)) return false;
+  capacity_ = half;
+  if (age_mark_ > high()) age_mark_ = high();
+  return true;
+}
+
+
 #ifdef DEBUG
 void SemiSpace::Print() { }
 #endif
@@ -1350,6 +1385,25 @@ int OldSpaceFreeList::Free(Address start, int size_in_bytes) {
 }
 
 
+void OldSpaceFreeList::Merge(OldSpaceFreeList* other) {
+  ASSERT(owner_ == other->owner_);
+  for (int i = 0; i < kFreeListsLength; i++) {
+    Address head = other->free_[i].head_node_;
+    if (head == NULL) continue;
+    // Put the other list in front of this list of the same size.
+    FreeListNode* last = FreeListNode::FromAddress(head);
+    while (last->next() != NULL) {
+      last = FreeListNode::FromAddress(last->next());
+    }
+    last->set_next(free_[i].head_node_);
+    free_[i].head_node_ = head;
+  }
+  available_ += other->available_;
+  needs_rebuild_ = true;
+  other->Reset();
+}
+
+
 Object* OldSpaceFreeList::Allocate(int size_in_bytes, int* wasted_bytes) {
   ASSERT(0 < size_in_bytes);
   ASSERT(size_in_bytes <= kMaxBlockSize);
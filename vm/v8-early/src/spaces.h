@@ -324,6 +324,11 @@ class MemoryAllocator : public AllStatic {
   // and false otherwise.
   static bool CommitBlock(Address start, size_t size);
 
+  // Uncommit a contiguous block of memory previously committed from the
+  // initial chunk with CommitBlock, returning it to the OS.  Returns true if
+  // it succeeded and false otherwise.
+  static bool UncommitBlock(Address start, size_t size);
+
   // Attempts to allocate the requested (non-zero) number of pages from the
   // OS.  Fewer pages might be allocated than requested. If it fails to
   // allocate memory for the OS or cannot allocate a single page, this
@@ -728,8 +733,8 @@ class PagedSpace : public Malloced {
   // of the space.
   int MCSpaceOffsetForAddress(Address addr);
 
-  // Releases half of unused pages.
-  void Shrink();
+  // Releases half of unused pages, or all of them if release_all is true.
+  void Shrink(bool release_all = false);
 
   // Ensures that the capacity is at least 'capacity'. Returns false on failure.
   bool EnsureCapacity(int capacity);
@@ -870,6 +875,10 @@ class SemiSpace  BASE_EMBEDDED {
   // address range to grow).
   bool Double();
 
+  // Halve the size of the semispace by uncommitting its upper half.  Assumes
+  // that the caller has checked that no objects live in the upper half.
+  bool Halve();
+
   // Returns the start address of the space.
   Address low() { return start_; }
   // Returns one past the end address of the space.
@@ -1000,6 +1009,11 @@ class NewSpace : public Malloced {
   // their maximum capacity.  Returns a flag indicating success or failure.
   bool Double();
 
+  // Halves the capacity of the semispaces.  Assumes that the allocated
+  // objects fit in the lower half of the active semispace.  Returns a flag
+  // indicating success or failure.
+  bool Halve();
+
   // True if the address or object lies in the address range of either
   // semispace (not necessarily below the allocation pointer).
   bool Contains(Address a) {
@@ -1202,6 +1216,10 @@ class OldSpaceFreeList BASE_EMBEDDED {
   // 'wasted_bytes'.  The size should be a non-zero multiple of the word size.
   Object* Allocate(int size_in_bytes, int* wasted_bytes);
 
+  // Move the blocks on another free list for the same space to this one,
+  // leaving the other list empty.
+  void Merge(OldSpaceFreeList* other);
+
  private:
   // The size range of blocks, in bytes. (Smaller allocations are allowed, but
   // will always result in waste.)
@@ -1352,6 +1370,17 @@ class OldSpace : public PagedSpace {
     accounting_stats_.WasteBytes(wasted_bytes);
   }
 
+  // Give the blocks on a free list filled by sweeping some of this space's
+  // pages elsewhere to the space, accounting for the bytes freed and
+  // wasted on those pages.
+  void MergeFreeList(OldSpaceFreeList* free_list,
+                     int freed_bytes,
+                     int wasted_bytes) {
+    free_list_.Merge(free_list);
+    accounting_stats_.DeallocateBytes(freed_bytes);
+    accounting_stats_.WasteBytes(wasted_bytes);
+  }
+
   // Prepare for full garbage collection.  Resets the relocation pointer and
   // clears the free list.
   void PrepareForMarkCompact(bool will_compact);
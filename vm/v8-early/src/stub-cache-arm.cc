@@ -41,23 +41,28 @@ static void ProbeTable(MacroAssembler* masm,
                        StubCache::Table table,
                        Register name,
                        Register offset) {
-  ExternalReference key_offset(SCTableReference::keyReference(table));
-  ExternalReference value_offset(SCTableReference::valueReference(table));
+  StubCache::Group group = StubCache::GroupFor(flags);
+  ExternalReference table_address(
+      SCTableReference::tableReference(table, group));
 
   Label miss;
 
   // Save the offset on the stack.
   __ push(offset);
 
+  // Compute the address of the entry. Entries are twice the size of
+  // the offset unit.
+  __ mov(ip, Operand(table_address));
+  __ ldr(ip, MemOperand(ip));
+  __ add(offset, ip, Operand(offset, LSL, 1));
+
   // Check that the key in the entry matches the name.
-  __ mov(ip, Operand(key_offset));
-  __ ldr(ip, MemOperand(ip, offset, LSL, 1));
+  __ ldr(ip, MemOperand(offset, OFFSET_OF(StubCache::Entry, key)));
   __ cmp(name, Operand(ip));
   __ b(ne, &miss);
 
   // Get the code entry from the cache.
-  __ mov(ip, Operand(value_offset));
-  __ ldr(offset, MemOperand(ip, offset, LSL, 1));
+  __ ldr(offset, MemOperand(offset, OFFSET_OF(StubCache::Entry, value)));
 
   // Check that the flags match what we're looking for.
   __ ldr(offset, FieldMemOperand(offset, Code::kFlagsOffset));
@@ -67,8 +72,10 @@ static void ProbeTable(MacroAssembler* masm,
 
   // Restore offset and re-load code entry from cache.
   __ pop(offset);
-  __ mov(ip, Operand(value_offset));
-  __ ldr(offset, MemOperand(ip, offset, LSL, 1));
+  __ mov(ip, Operand(table_address));
+  __ ldr(ip, MemOperand(ip));
+  __ add(offset, ip, Operand(offset, LSL, 1));
+  __ ldr(offset, MemOperand(offset, OFFSET_OF(StubCache::Entry, value)));
 
   // Jump to the first instruction in the code stub.
   __ add(offset, offset, Operand(Code::kHeaderSize - kHeapObjectTag));
@@ -98,6 +105,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!scratch.is(receiver));
   ASSERT(!scratch.is(name));
 
+  // The table sizes are only known at runtime; load the masks.
+  ExternalReference primary_mask(SCTableReference::maskReference(kPrimary));
+  ExternalReference secondary_mask(
+      SCTableReference::maskReference(kSecondary));
+
   // Check that the receiver isn't a smi.
   __ tst(receiver, Operand(kSmiTagMask));
   __ b(eq, &miss);
@@ -107,9 +119,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ ldr(ip, FieldMemOperand(name, String::kLengthOffset));
   __ add(scratch, scratch, Operand(ip));
   __ eor(scratch, scratch, Operand(flags));
-  __ and_(scratch,
-          scratch,
-          Operand((kPrimaryTableSize - 1) << kHeapObjectTagSize));
+  __ mov(ip, Operand(primary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip));
 
   // Probe the primary table.
   ProbeTable(masm, flags, kPrimary, name, scratch);
@@ -117,9 +129,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   // Primary miss: Compute hash for secondary probe.
   __ sub(scratch, scratch, Operand(name));
   __ add(scratch, scratch, Operand(flags));
-  __ and_(scratch,
-          scratch,
-          Operand((kSecondaryTableSize - 1) << kHeapObjectTagSize));
+  __ mov(ip, Operand(secondary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip));
 
   // Probe the secondary table.
   ProbeTable(masm, flags, kSecondary, name, scratch);
@@ -368,6 +380,39 @@ Object* CallStubCompiler::CompileCallInterceptor(Object* object,
 }
 
 
+Object* CallStubCompiler::CompileCallPolymorphic(Map** maps,
+                                                 Code** stubs,
+                                                 int count) {
+  // ----------- S t a t e -------------
+  //  -- r0: number of arguments
+  //  -- r1: receiver
+  //  -- lr: return address
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  // Check that the receiver isn't a smi.
+  __ tst(r1, Operand(kSmiTagMask));
+  __ b(eq, &miss);
+
+  // Dispatch to the monomorphic stub for the receiver map.
+  __ ldr(r3, FieldMemOperand(r1, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(r3, Operand(Handle<Map>(maps[i])));
+    __ Jump(Handle<Code>(stubs[i]), code_target, eq);
+  }
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Handle<Code> ic = ComputeCallMiss(arguments().immediate());
+  __ Jump(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* StoreStubCompiler::CompileStoreField(JSObject* object,
                                              int index,
                                              Map* transition,
@@ -403,32 +448,49 @@ Object* StoreStubCompiler::CompileStoreField(JSObject* object,
   // checks.
   ASSERT(object->IsJSGlobalObject() || !object->IsAccessCheckNeeded());
 
-  // Get the properties array
-  __ ldr(r1, FieldMemOperand(r3, JSObject::kPropertiesOffset));
-
-  // Perform map transition for the receiver if necessary.
-  if (transition != NULL) {
-    // Update the map of the object; no write barrier updating is
-    // needed because the map is never in new space.
+  // Check that we have room for the new property; if not, the
+  // properties array has to be extended in the runtime system, which
+  // also does the map transition.
+  if ((transition != NULL) && (object->map()->unused_property_fields() == 0)) {
+    __ push(r3);  // receiver
     __ mov(ip, Operand(Handle<Map>(transition)));
-    __ str(ip, FieldMemOperand(r3, HeapObject::kMapOffset));
-  }
+    __ push(ip);
+    __ mov(ip, Operand(Smi::FromInt(index)));
+    __ push(ip);
+    __ push(r0);  // value
+
+    // Do tail-call to the C builtin.
+    __ mov(r0, Operand(3));  // not counting receiver
+    __ JumpToBuiltin(
+        ExternalReference(IC_Utility(IC::kSharedStoreIC_ExtendStorage)));
+  } else {
+    // Get the properties array
+    __ ldr(r1, FieldMemOperand(r3, JSObject::kPropertiesOffset));
+
+    // Perform map transition for the receiver if necessary.
+    if (transition != NULL) {
+      // Update the map of the object; no write barrier updating is
+      // needed because the map is never in new space.
+      __ mov(ip, Operand(Handle<Map>(transition)));
+      __ str(ip, FieldMemOperand(r3, HeapObject::kMapOffset));
+    }
 
-  // Write to the properties array.
-  int offset = index * kPointerSize + Array::kHeaderSize;
-  __ str(r0, FieldMemOperand(r1, offset));
+    // Write to the properties array.
+    int offset = index * kPointerSize + Array::kHeaderSize;
+    __ str(r0, FieldMemOperand(r1, offset));
 
-  // Skip updating write barrier if storing a smi.
-  __ tst(r0, Operand(kSmiTagMask));
-  __ b(eq, &exit);
+    // Skip updating write barrier if storing a smi.
+    __ tst(r0, Operand(kSmiTagMask));
+    __ b(eq, &exit);
 
-  // Update the write barrier for the array address.
-  __ mov(r3, Operand(offset));
-  __ RecordWrite(r1, r3, r2);  // OK to clobber r2, since we return
+    // Update the write barrier for the array address.
+    __ mov(r3, Operand(offset));
+    __ RecordWrite(r1, r3, r2);  // OK to clobber r2, since we return
 
-  // Return the value (register r0).
-  __ bind(&exit);
-  __ Ret();
+    // Return the value (register r0).
+    __ bind(&exit);
+    __ Ret();
+  }
 
   // Handle store cache miss.
   __ bind(&miss);
@@ -552,6 +614,43 @@ Object* StoreStubCompiler::CompileStoreInterceptor(JSObject* receiver,
 }
 
 
+Object* StoreStubCompiler::CompileStorePolymorphic(Map** maps,
+                                                   Code** stubs,
+                                                   int count) {
+  // ----------- S t a t e -------------
+  //  -- r0    : value
+  //  -- r2    : name
+  //  -- lr    : return address
+  //  -- [sp]  : receiver
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  // Get the object from the stack.
+  __ ldr(r3, MemOperand(sp, 0 * kPointerSize));
+
+  // Check that the object isn't a smi.
+  __ tst(r3, Operand(kSmiTagMask));
+  __ b(eq, &miss);
+
+  // Dispatch to the monomorphic stub for the receiver map.
+  __ ldr(r1, FieldMemOperand(r3, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(r1, Operand(Handle<Map>(maps[i])));
+    __ Jump(Handle<Code>(stubs[i]), code_target, eq);
+  }
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ Jump(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* LoadStubCompiler::CompileLoadField(JSObject* object,
                                            JSObject* holder,
                                            int index) {
@@ -705,6 +804,40 @@ Object* LoadStubCompiler::CompileLoadInterceptor(JSObject* object,
 }
 
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(Map** maps,
+                                                 Code** stubs,
+                                                 int count) {
+  // ----------- S t a t e -------------
+  //  -- r0    : receiver
+  //  -- r2    : name
+  //  -- lr    : return address
+  //  -- [sp]  : receiver
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  // Check that the receiver isn't a smi.
+  __ tst(r0, Operand(kSmiTagMask));
+  __ b(eq, &miss);
+
+  // Dispatch to the monomorphic stub for the receiver map.
+  __ ldr(r3, FieldMemOperand(r0, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(r3, Operand(Handle<Map>(maps[i])));
+    __ Jump(Handle<Code>(stubs[i]), code_target, eq);
+  }
+
+  // Handle load cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::LoadIC_Miss));
+  __ Jump(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 // TODO(1224671): IC stubs for keyed loads have not been implemented
 // for ARM.
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
@@ -772,6 +905,20 @@ Object* KeyedLoadStubCompiler::CompileLoadFunctionPrototype(String* name) {
 }
 
 
+Object* KeyedLoadStubCompiler::CompileLoadFastElement(JSObject* object) {
+  UNIMPLEMENTED();
+  return Heap::undefined_value();
+}
+
+
+Object* KeyedLoadStubCompiler::CompileLoadPolymorphic(Map** maps,
+                                                      Code** stubs,
+                                                      int count) {
+  UNIMPLEMENTED();
+  return Heap::undefined_value();
+}
+
+
 Object* KeyedStoreStubCompiler::CompileStoreField(JSObject* object,
                                                   int index,
                                                   Map* transition,
@@ -781,6 +928,20 @@ Object* KeyedStoreStubCompiler::CompileStoreField(JSObject* object,
 }
 
 
+Object* KeyedStoreStubCompiler::CompileStoreFastElement(JSObject* object) {
+  UNIMPLEMENTED();
+  return Heap::undefined_value();
+}
+
+
+Object* KeyedStoreStubCompiler::CompileStorePolymorphic(Map** maps,
+                                                        Code** stubs,
+                                                        int count) {
+  UNIMPLEMENTED();
+  return Heap::undefined_value();
+}
+
+
 
 #undef __
 
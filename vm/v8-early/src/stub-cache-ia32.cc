@@ -40,21 +40,28 @@ static void ProbeTable(MacroAssembler* masm,
                        Code::Flags flags,
                        StubCache::Table table,
                        Register name,
-                       Register offset) {
-  ExternalReference key_offset(SCTableReference::keyReference(table));
-  ExternalReference value_offset(SCTableReference::valueReference(table));
+                       Register offset,
+                       StatsCounter* hits) {
+  StubCache::Group group = StubCache::GroupFor(flags);
+  ExternalReference table_address(
+      SCTableReference::tableReference(table, group));
 
   Label miss;
 
   // Save the offset on the stack.
   __ push(offset);
 
+  // Compute the address of the entry. Entries are twice the size of
+  // the offset unit.
+  __ add(offset, Operand(offset));
+  __ add(offset, Operand::StaticVariable(table_address));
+
   // Check that the key in the entry matches the name.
-  __ cmp(name, Operand::StaticArray(offset, times_2, key_offset));
+  __ cmp(name, Operand(offset, OFFSET_OF(StubCache::Entry, key)));
   __ j(not_equal, &miss, not_taken);
 
   // Get the code entry from the cache.
-  __ mov(offset, Operand::StaticArray(offset, times_2, value_offset));
+  __ mov(offset, Operand(offset, OFFSET_OF(StubCache::Entry, value)));
 
   // Check that the flags match what we're looking for.
   __ mov(offset, FieldOperand(offset, Code::kFlagsOffset));
@@ -64,7 +71,10 @@ static void ProbeTable(MacroAssembler* masm,
 
   // Restore offset and re-load code entry from cache.
   __ pop(offset);
-  __ mov(offset, Operand::StaticArray(offset, times_2, value_offset));
+  __ IncrementCounter(hits, 1);
+  __ add(offset, Operand(offset));
+  __ add(offset, Operand::StaticVariable(table_address));
+  __ mov(offset, Operand(offset, OFFSET_OF(StubCache::Entry, value)));
 
   // Jump to the first instruction in the code stub.
   __ add(Operand(offset), Immediate(Code::kHeaderSize - kHeapObjectTag));
@@ -94,6 +104,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   ASSERT(!scratch.is(receiver));
   ASSERT(!scratch.is(name));
 
+  // The table sizes are only known at runtime; load the masks.
+  ExternalReference primary_mask(SCTableReference::maskReference(kPrimary));
+  ExternalReference secondary_mask(
+      SCTableReference::maskReference(kSecondary));
+
   // Check that the receiver isn't a smi.
   __ test(receiver, Immediate(kSmiTagMask));
   __ j(zero, &miss, not_taken);
@@ -102,22 +117,25 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ mov(scratch, FieldOperand(receiver, HeapObject::kMapOffset));
   __ add(scratch, FieldOperand(name, String::kLengthOffset));
   __ xor_(scratch, flags);
-  __ and_(scratch, (kPrimaryTableSize - 1) << kHeapObjectTagSize);
+  __ and_(scratch, Operand::StaticVariable(primary_mask));
 
   // Probe the primary table.
-  ProbeTable(masm, flags, kPrimary, name, scratch);
+  ProbeTable(masm, flags, kPrimary, name, scratch,
+             &Counters::stub_cache_primary_hits);
 
   // Primary miss: Compute hash for secondary probe.
   __ sub(scratch, Operand(name));
   __ add(Operand(scratch), Immediate(flags));
-  __ and_(scratch, (kSecondaryTableSize - 1) << kHeapObjectTagSize);
+  __ and_(scratch, Operand::StaticVariable(secondary_mask));
 
   // Probe the secondary table.
-  ProbeTable(masm, flags, kSecondary, name, scratch);
+  ProbeTable(masm, flags, kSecondary, name, scratch,
+             &Counters::stub_cache_secondary_hits);
 
   // Cache miss: Fall-through and let caller handle the miss by
   // entering the runtime system.
   __ bind(&miss);
+  __ IncrementCounter(&Counters::stub_cache_misses, 1);
 }
 
 
@@ -429,6 +447,22 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
   // checks.
   ASSERT(object->IsJSGlobalObject() || !object->IsAccessCheckNeeded());
 
+  // Check that we have room for the new property; if not, the
+  // properties array has to be extended in the runtime system, which
+  // also does the map transition.
+  if ((transition != NULL) && (object->map()->unused_property_fields() == 0)) {
+    __ pop(scratch);  // remove the return address
+    __ push(receiver_reg);
+    __ push(Immediate(Handle<Map>(transition)));
+    __ push(Immediate(Smi::FromInt(index)));
+    __ push(eax);
+    __ push(scratch);  // restore return address
+    __ mov(eax, 3);  // not counting receiver
+    __ JumpToBuiltin(
+        ExternalReference(IC_Utility(IC::kSharedStoreIC_ExtendStorage)));
+    return;
+  }
+
   // Get the properties array (optimistically).
   __ mov(scratch, FieldOperand(receiver_reg, JSObject::kPropertiesOffset));
 
@@ -454,6 +488,95 @@ void StubCompiler::GenerateStoreField(MacroAssembler* masm,
 }
 
 
+// Generate the inlined version of a builtin function called with a single
+// argument. The result is returned directly to the caller; arguments that
+// the fast case does not handle jump to the slow label.
+static void GenerateIntrinsic(MacroAssembler* masm,
+                              StubCompiler::Intrinsic id,
+                              int argc,
+                              Label* slow) {
+  ASSERT(argc == 1);
+  // Get the argument from the stack and check that it is a smi.
+  __ mov(eax, Operand(esp, 1 * kPointerSize));
+  __ test(eax, Immediate(kSmiTagMask));
+  __ j(not_zero, slow, not_taken);
+
+  switch (id) {
+    case StubCompiler::MATH_ABS: {
+      Label done;
+      __ test(eax, Operand(eax));
+      __ j(not_sign, &done, taken);
+      __ neg(eax);
+      // The negation of the smallest smi is not a smi.
+      __ j(overflow, slow, not_taken);
+      __ bind(&done);
+      break;
+    }
+
+    case StubCompiler::MATH_FLOOR:
+    case StubCompiler::MATH_CEIL:
+    case StubCompiler::MATH_ROUND:
+      // Smis are integral already.
+      break;
+
+    case StubCompiler::STRING_CHAR_CODE_AT: {
+      // Get the receiver and its instance type. The receiver is known
+      // to be a string.
+      __ mov(edx, Operand(esp, (argc + 1) * kPointerSize));
+      __ mov(ecx, FieldOperand(edx, HeapObject::kMapOffset));
+      __ movzx_b(ecx, FieldOperand(ecx, Map::kInstanceTypeOffset));
+      // Only sequential strings can be accessed directly.
+      __ test(ecx, Immediate(kStringRepresentationMask));
+      __ j(not_zero, slow, not_taken);
+
+      // Compute the length of the string in ebx.
+      Label medium, long_string, length_done;
+      __ mov(ebx, FieldOperand(edx, String::kLengthOffset));
+      __ mov(edi, Operand(ecx));
+      __ and_(edi, kStringSizeMask);
+      __ cmp(edi, kMediumStringTag);
+      __ j(equal, &medium);
+      __ cmp(edi, kLongStringTag);
+      __ j(equal, &long_string);
+      __ shr(ebx, String::kShortLengthShift);
+      __ jmp(&length_done);
+      __ bind(&medium);
+      __ shr(ebx, String::kMediumLengthShift);
+      __ jmp(&length_done);
+      __ bind(&long_string);
+      __ shr(ebx, String::kLongLengthShift);
+      __ bind(&length_done);
+
+      // Check the index against the length. The unsigned comparison
+      // sends negative indices to the slow case as well.
+      __ mov(edi, Operand(eax));
+      __ sar(edi, kSmiTagSize);
+      __ cmp(edi, Operand(ebx));
+      __ j(above_equal, slow, not_taken);
+
+      // Load the character and tag it as a smi.
+      Label two_byte, tag;
+      __ test(ecx, Immediate(kStringEncodingMask));
+      __ j(zero, &two_byte);
+      __ movzx_b(eax, Operand(edx, edi, times_1,
+                              AsciiString::kHeaderSize - kHeapObjectTag));
+      __ jmp(&tag);
+      __ bind(&two_byte);
+      __ movzx_w(eax, Operand(edx, edi, times_2,
+                              TwoByteString::kHeaderSize - kHeapObjectTag));
+      __ bind(&tag);
+      __ shl(eax, kSmiTagSize);
+      break;
+    }
+
+    default:
+      UNREACHABLE();
+  }
+
+  __ ret((argc + 1) * kPointerSize);
+}
+
+
 #undef __
 
 #define __ masm()->
@@ -622,6 +745,20 @@ Object* CallStubCompiler::CompileCallConstant(Object* object,
       UNREACHABLE();
   }
 
+  // Inline builtins for the common single argument cases. Math functions
+  // are called on the Math object itself and charCodeAt on string values.
+  Object* intrinsic = Top::LookupIntrinsicFunction(function);
+  if (argc == 1 && intrinsic->IsSmi()) {
+    Intrinsic id = static_cast<Intrinsic>(Smi::cast(intrinsic)->value());
+    bool is_string_intrinsic = (id == STRING_CHAR_CODE_AT);
+    if (is_string_intrinsic == (check == STRING_CHECK) &&
+        (is_string_intrinsic || check == RECEIVER_MAP_CHECK)) {
+      Label slow;
+      GenerateIntrinsic(masm(), id, argc, &slow);
+      __ bind(&slow);
+    }
+  }
+
   // Get the function and setup the context.
   __ mov(Operand(edi), Immediate(Handle<JSFunction>(function)));
   __ mov(esi, FieldOperand(edi, JSFunction::kContextOffset));
@@ -708,6 +845,41 @@ Object* CallStubCompiler::CompileCallInterceptor(Object* object,
 }
 
 
+Object* CallStubCompiler::CompileCallPolymorphic(Map** maps,
+                                                 Code** stubs,
+                                                 int count) {
+  // ----------- S t a t e -------------
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  // Get the receiver from the stack.
+  const int argc = arguments().immediate();
+  __ mov(edx, Operand(esp, (argc + 1) * kPointerSize));
+
+  // Check that the receiver isn't a smi.
+  __ test(edx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Dispatch to the monomorphic stub for the receiver map. The stubs
+  // reload the receiver and redo all their checks.
+  __ mov(edx, FieldOperand(edx, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(Operand(edx), Immediate(Handle<Map>(maps[i])));
+    __ j(equal, Handle<Code>(stubs[i]));
+  }
+
+  // Handle call cache miss.
+  __ bind(&miss);
+  Handle<Code> ic = ComputeCallMiss(argc);
+  __ jmp(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* StoreStubCompiler::CompileStoreField(JSObject* object,
                                              int index,
                                              Map* transition,
@@ -851,6 +1023,43 @@ Object* StoreStubCompiler::CompileStoreInterceptor(JSObject* receiver,
 }
 
 
+Object* StoreStubCompiler::CompileStorePolymorphic(Map** maps,
+                                                   Code** stubs,
+                                                   int count) {
+  // ----------- S t a t e -------------
+  //  -- eax    : value
+  //  -- ecx    : name
+  //  -- esp[0] : return address
+  //  -- esp[4] : receiver
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  // Get the object from the stack.
+  __ mov(ebx, Operand(esp, 1 * kPointerSize));
+
+  // Check that the object isn't a smi.
+  __ test(ebx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Dispatch to the monomorphic stub for the receiver map.
+  __ mov(ebx, FieldOperand(ebx, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(Operand(ebx), Immediate(Handle<Map>(maps[i])));
+    __ j(equal, Handle<Code>(stubs[i]));
+  }
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::StoreIC_Miss));
+  __ jmp(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* KeyedStoreStubCompiler::CompileStoreField(JSObject* object,
                                                   int index,
                                                   Map* transition,
@@ -889,6 +1098,121 @@ Object* KeyedStoreStubCompiler::CompileStoreField(JSObject* object,
 }
 
 
+Object* KeyedStoreStubCompiler::CompileStoreFastElement(JSObject* object) {
+  // ----------- S t a t e -------------
+  //  -- eax    : value
+  //  -- esp[0] : return address
+  //  -- esp[4] : key
+  //  -- esp[8] : receiver
+  // -----------------------------------
+  HandleScope scope;
+  Label miss, fast;
+
+  __ IncrementCounter(&Counters::keyed_store_fast_element, 1);
+
+  // Get the key and the object from the stack.
+  __ mov(ebx, Operand(esp, 1 * kPointerSize));
+  __ mov(edx, Operand(esp, 2 * kPointerSize));
+
+  // Check that the object isn't a smi.
+  __ test(edx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Check that the map of the object hasn't changed.
+  __ cmp(FieldOperand(edx, HeapObject::kMapOffset),
+         Immediate(Handle<Map>(object->map())));
+  __ j(not_equal, &miss, not_taken);
+
+  // Check that the key is a smi.
+  __ test(ebx, Immediate(kSmiTagMask));
+  __ j(not_zero, &miss, not_taken);
+
+  // Check that the elements are in fast mode (not dictionary).
+  __ mov(ecx, FieldOperand(edx, JSObject::kElementsOffset));
+  __ cmp(FieldOperand(ecx, HeapObject::kMapOffset),
+         Immediate(Factory::hash_table_map()));
+  __ j(equal, &miss, not_taken);
+
+  // Check that the key is within bounds. Negative keys fail the
+  // unsigned comparisons.
+  // eax: value
+  // edx: JSObject
+  // ecx: FixedArray
+  // ebx: index (as a smi)
+  if (object->IsJSArray()) {
+    __ cmp(ebx, FieldOperand(edx, JSArray::kLengthOffset));
+    __ j(below, &fast, taken);
+    // Allow adding one element to the array by writing to
+    // array[array.length] if there is extra capacity.
+    __ j(not_equal, &miss, not_taken);  // do not leave holes in the array
+    __ sar(ebx, kSmiTagSize);  // untag
+    __ cmp(ebx, FieldOperand(ecx, Array::kLengthOffset));
+    __ j(above_equal, &miss, not_taken);
+    // Restore tag and increment.
+    __ lea(ebx, Operand(ebx, times_2, 1 << kSmiTagSize));
+    __ mov(FieldOperand(edx, JSArray::kLengthOffset), ebx);
+    __ sub(Operand(ebx), Immediate(1 << kSmiTagSize));  // decrement ebx again
+  } else {
+    __ mov(edx, Operand(ebx));
+    __ sar(edx, kSmiTagSize);  // untag the index and use it for the comparison
+    __ cmp(edx, FieldOperand(ecx, Array::kLengthOffset));
+    __ j(above_equal, &miss, not_taken);
+  }
+
+  // Do the store and update the write barrier for the elements array.
+  __ bind(&fast);
+  __ mov(Operand(ecx, ebx, times_2, Array::kHeaderSize - kHeapObjectTag), eax);
+  __ mov(edx, Operand(eax));
+  __ RecordWrite(ecx, 0, edx, ebx);
+  __ ret(0);
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  __ DecrementCounter(&Counters::keyed_store_fast_element, 1);
+  Handle<Code> ic(Builtins::builtin(Builtins::KeyedStoreIC_Miss));
+  __ jmp(ic, code_target);
+
+  // Return the generated code.
+  return GetCode(NORMAL);
+}
+
+
+Object* KeyedStoreStubCompiler::CompileStorePolymorphic(Map** maps,
+                                                        Code** stubs,
+                                                        int count) {
+  // ----------- S t a t e -------------
+  //  -- eax    : value
+  //  -- esp[0] : return address
+  //  -- esp[4] : key
+  //  -- esp[8] : receiver
+  // -----------------------------------
+  HandleScope scope;
+  Label miss;
+
+  // Get the object from the stack.
+  __ mov(edx, Operand(esp, 2 * kPointerSize));
+
+  // Check that the object isn't a smi.
+  __ test(edx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Dispatch to the fast elements stub for the receiver map.
+  __ mov(edx, FieldOperand(edx, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(Operand(edx), Immediate(Handle<Map>(maps[i])));
+    __ j(equal, Handle<Code>(stubs[i]));
+  }
+
+  // Handle store cache miss.
+  __ bind(&miss);
+  Handle<Code> ic(Builtins::builtin(Builtins::KeyedStoreIC_Miss));
+  __ jmp(ic, code_target);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* LoadStubCompiler::CompileLoadField(JSObject* object,
                                            JSObject* holder,
                                            int index) {
@@ -977,6 +1301,39 @@ Object* LoadStubCompiler::CompileLoadInterceptor(JSObject* receiver,
 }
 
 
+Object* LoadStubCompiler::CompileLoadPolymorphic(Map** maps,
+                                                 Code** stubs,
+                                                 int count) {
+  // ----------- S t a t e -------------
+  //  -- ecx    : name
+  //  -- esp[0] : return address
+  //  -- esp[4] : receiver
+  // -----------------------------------
+
+  HandleScope scope;
+  Label miss;
+
+  __ mov(eax, (Operand(esp, kPointerSize)));
+
+  // Check that the receiver isn't a smi.
+  __ test(eax, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Dispatch to the monomorphic stub for the receiver map.
+  __ mov(eax, FieldOperand(eax, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(Operand(eax), Immediate(Handle<Map>(maps[i])));
+    __ j(equal, Handle<Code>(stubs[i]));
+  }
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 Object* KeyedLoadStubCompiler::CompileLoadField(String* name,
                                                 JSObject* receiver,
                                                 JSObject* holder,
@@ -1234,6 +1591,136 @@ Object* KeyedLoadStubCompiler::CompileLoadFunctionPrototype(String* name) {
 }
 
 
+// Returns whether a hole in the elements of the object can be loaded
+// as undefined after checking the maps and the (empty) elements of the
+// objects in the prototype chain.
+static bool CanLoadHoleAsUndefined(JSObject* object) {
+  Object* current = object->GetPrototype();
+  while (!current->IsNull()) {
+    if (!current->IsJSObject()) return false;
+    JSObject* prototype = JSObject::cast(current);
+    if (Heap::InNewSpace(prototype)) return false;
+    if (prototype->IsAccessCheckNeeded()) return false;
+    if (prototype->map()->has_indexed_interceptor()) return false;
+    if (prototype->elements() != Heap::empty_fixed_array()) return false;
+    current = prototype->GetPrototype();
+  }
+  return true;
+}
+
+
+Object* KeyedLoadStubCompiler::CompileLoadFastElement(JSObject* object) {
+  // ----------- S t a t e -------------
+  //  -- esp[0] : return address
+  //  -- esp[4] : key
+  //  -- esp[8] : receiver
+  // -----------------------------------
+  HandleScope scope;
+  Label miss, hole;
+
+  __ mov(eax, (Operand(esp, kPointerSize)));
+  __ mov(ecx, (Operand(esp, 2 * kPointerSize)));
+  __ IncrementCounter(&Counters::keyed_load_fast_element, 1);
+
+  // Check that the receiver isn't a smi.
+  __ test(ecx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Check that the map of the receiver hasn't changed.
+  __ cmp(FieldOperand(ecx, HeapObject::kMapOffset),
+         Immediate(Handle<Map>(object->map())));
+  __ j(not_equal, &miss, not_taken);
+
+  // Check that the key is a smi.
+  __ test(eax, Immediate(kSmiTagMask));
+  __ j(not_zero, &miss, not_taken);
+
+  // Check that the elements are in fast mode (not dictionary).
+  __ mov(edx, FieldOperand(ecx, JSObject::kElementsOffset));
+  __ cmp(FieldOperand(edx, HeapObject::kMapOffset),
+         Immediate(Factory::hash_table_map()));
+  __ j(equal, &miss, not_taken);
+
+  // Check that the key is within bounds. Negative keys fail the
+  // unsigned comparisons. The elements of fast mode arrays are at
+  // least as long as the array.
+  if (object->IsJSArray()) {
+    __ cmp(eax, FieldOperand(ecx, JSArray::kLengthOffset));
+    __ j(above_equal, &miss, not_taken);
+  } else {
+    __ mov(ebx, Operand(eax));
+    __ sar(ebx, kSmiTagSize);
+    __ cmp(ebx, FieldOperand(edx, Array::kLengthOffset));
+    __ j(above_equal, &miss, not_taken);
+  }
+
+  // Do the load. The key is a smi, so scale by half a pointer.
+  __ mov(eax, Operand(edx, eax, times_2, Array::kHeaderSize - kHeapObjectTag));
+  __ cmp(Operand(eax), Immediate(Factory::the_hole_value()));
+  __ j(equal, &hole, not_taken);
+  __ ret(0);
+
+  // A hole is undefined if the prototype chain is unchanged and has
+  // no elements; otherwise the runtime system searches the chain.
+  __ bind(&hole);
+  if (CanLoadHoleAsUndefined(object)) {
+    Object* current = object->GetPrototype();
+    while (!current->IsNull()) {
+      JSObject* prototype = JSObject::cast(current);
+      __ mov(ebx, Handle<JSObject>(prototype));
+      __ cmp(FieldOperand(ebx, HeapObject::kMapOffset),
+             Immediate(Handle<Map>(prototype->map())));
+      __ j(not_equal, &miss, not_taken);
+      __ cmp(FieldOperand(ebx, JSObject::kElementsOffset),
+             Immediate(Factory::empty_fixed_array()));
+      __ j(not_equal, &miss, not_taken);
+      current = prototype->GetPrototype();
+    }
+    __ Set(eax, Immediate(Factory::undefined_value()));
+    __ ret(0);
+  }
+
+  __ bind(&miss);
+  __ DecrementCounter(&Counters::keyed_load_fast_element, 1);
+  GenerateLoadMiss(masm(), Code::KEYED_LOAD_IC);
+
+  // Return the generated code.
+  return GetCode(NORMAL);
+}
+
+
+Object* KeyedLoadStubCompiler::CompileLoadPolymorphic(Map** maps,
+                                                      Code** stubs,
+                                                      int count) {
+  // ----------- S t a t e -------------
+  //  -- esp[0] : return address
+  //  -- esp[4] : key
+  //  -- esp[8] : receiver
+  // -----------------------------------
+  HandleScope scope;
+  Label miss;
+
+  __ mov(ecx, (Operand(esp, 2 * kPointerSize)));
+
+  // Check that the receiver isn't a smi.
+  __ test(ecx, Immediate(kSmiTagMask));
+  __ j(zero, &miss, not_taken);
+
+  // Dispatch to the fast elements stub for the receiver map.
+  __ mov(ecx, FieldOperand(ecx, HeapObject::kMapOffset));
+  for (int i = 0; i < count; i++) {
+    __ cmp(Operand(ecx), Immediate(Handle<Map>(maps[i])));
+    __ j(equal, Handle<Code>(stubs[i]));
+  }
+
+  __ bind(&miss);
+  GenerateLoadMiss(masm(), Code::KEYED_LOAD_IC);
+
+  // Return the generated code.
+  return GetPolymorphicCode();
+}
+
+
 #undef __
 
 } }  // namespace v8::internal
@@ -38,12 +38,114 @@ namespace v8 { namespace internal {
 // StubCache implementation.
 
 
-StubCache::Entry StubCache::primary_[StubCache::kPrimaryTableSize];
-StubCache::Entry StubCache::secondary_[StubCache::kSecondaryTableSize];
+StubCache::Entry* StubCache::primary_[StubCache::kGroupCount];
+StubCache::Entry* StubCache::secondary_[StubCache::kGroupCount];
+int StubCache::primary_size_ = 0;
+int StubCache::secondary_size_ = 0;
+bool StubCache::separate_tables_ = false;
+int StubCache::primary_mask_ = 0;
+int StubCache::secondary_mask_ = 0;
+
+
+// Polymorphic stubs are cached by their flags, name and the receiver
+// maps and stubs they dispatch to, so that inline caches seeing the
+// same maps share one stub and misses on a handled map do not compile
+// a new one. The cache holds raw pointers and is cleared together with
+// the tables above.
+struct PolymorphicEntry {
+  Code::Flags flags;
+  String* name;
+  int count;
+  Map* maps[IC::kMaxPolymorphism];
+  Code* stubs[IC::kMaxPolymorphism];
+  Code* value;
+};
+
+static const int kPolymorphicCacheSize = 64;
+static PolymorphicEntry polymorphic_cache[kPolymorphicCacheSize];
+
+
+static PolymorphicEntry* PolymorphicCacheEntry(Code::Flags flags,
+                                               String* name,
+                                               Map** maps,
+                                               Code** stubs,
+                                               int count) {
+  uint32_t hash = flags ^ reinterpret_cast<uint32_t>(name);
+  for (int i = 0; i < count; i++) {
+    hash = hash * 31 + reinterpret_cast<uint32_t>(maps[i]);
+    hash = hash * 31 + reinterpret_cast<uint32_t>(stubs[i]);
+  }
+  hash ^= hash >> 16;
+  int index = (hash >> kHeapObjectTagSize) & (kPolymorphicCacheSize - 1);
+  return &polymorphic_cache[index];
+}
+
+
+// Returns the cached polymorphic stub for the maps and stubs, or NULL.
+static Code* FindPolymorphicStub(Code::Flags flags,
+                                 String* name,
+                                 Map** maps,
+                                 Code** stubs,
+                                 int count) {
+  ASSERT(count <= IC::kMaxPolymorphism);
+  PolymorphicEntry* entry =
+      PolymorphicCacheEntry(flags, name, maps, stubs, count);
+  if (entry->value == NULL || entry->flags != flags ||
+      entry->name != name || entry->count != count) {
+    return NULL;
+  }
+  for (int i = 0; i < count; i++) {
+    if (entry->maps[i] != maps[i] || entry->stubs[i] != stubs[i]) {
+      return NULL;
+    }
+  }
+  return entry->value;
+}
+
+
+static void AddPolymorphicStub(Code::Flags flags,
+                               String* name,
+                               Map** maps,
+                               Code** stubs,
+                               int count,
+                               Code* code) {
+  ASSERT(count <= IC::kMaxPolymorphism);
+  PolymorphicEntry* entry =
+      PolymorphicCacheEntry(flags, name, maps, stubs, count);
+  entry->flags = flags;
+  entry->name = name;
+  entry->count = count;
+  for (int i = 0; i < count; i++) {
+    entry->maps[i] = maps[i];
+    entry->stubs[i] = stubs[i];
+  }
+  entry->value = code;
+}
 
-void StubCache::Initialize(bool create_heap_objects) {
-  ASSERT(IsPowerOf2(kPrimaryTableSize));
-  ASSERT(IsPowerOf2(kSecondaryTableSize));
+void StubCache::Initialize(bool create_heap_objects,
+                           int primary_size,
+                           int secondary_size,
+                           bool separate_tables) {
+  ASSERT(IsPowerOf2(primary_size));
+  ASSERT(IsPowerOf2(secondary_size));
+  // The tables are allocated once and kept for the lifetime of the
+  // process.
+  if (primary_[kLoadGroup] == NULL) {
+    primary_size_ = primary_size;
+    secondary_size_ = secondary_size;
+    separate_tables_ = separate_tables;
+    for (int i = 0; i < kGroupCount; i++) {
+      if (i == kLoadGroup || separate_tables_) {
+        primary_[i] = NewArray<Entry>(primary_size_);
+        secondary_[i] = NewArray<Entry>(secondary_size_);
+      } else {
+        primary_[i] = primary_[kLoadGroup];
+        secondary_[i] = secondary_[kLoadGroup];
+      }
+    }
+    primary_mask_ = (primary_size_ - 1) << kHeapObjectTagSize;
+    secondary_mask_ = (secondary_size_ - 1) << kHeapObjectTagSize;
+  }
   if (create_heap_objects) {
     HandleScope scope;
     Clear();
@@ -51,6 +153,19 @@ void StubCache::Initialize(bool create_heap_objects) {
 }
 
 
+StubCache::Group StubCache::GroupFor(Code::Flags flags) {
+  switch (Code::ExtractKindFromFlags(flags)) {
+    case Code::STORE_IC:
+    case Code::KEYED_STORE_IC:
+      return kStoreGroup;
+    case Code::CALL_IC:
+      return kCallGroup;
+    default:
+      return kLoadGroup;
+  }
+}
+
+
 Code* StubCache::Set(String* name, Map* map, Code* code) {
   // Get the flags from the code.
   Code::Flags flags = Code::RemoveTypeFromFlags(code->flags());
@@ -71,8 +186,9 @@ Code* StubCache::Set(String* name, Map* map, Code* code) {
   ASSERT(Code::ExtractTypeFromFlags(flags) == 0);
 
   // Compute the primary entry.
+  Group group = GroupFor(flags);
   int primary_offset = PrimaryOffset(name, flags, map);
-  Entry* primary = entry(primary_, primary_offset);
+  Entry* primary = entry(primary_[group], primary_offset);
   Code* hit = primary->value;
 
   // If the primary entry has useful data in it, we retire it to the
@@ -81,7 +197,7 @@ Code* StubCache::Set(String* name, Map* map, Code* code) {
     Code::Flags primary_flags = Code::RemoveTypeFromFlags(hit->flags());
     int secondary_offset =
         SecondaryOffset(primary->key, primary_flags, primary_offset);
-    Entry* secondary = entry(secondary_, secondary_offset);
+    Entry* secondary = entry(secondary_[group], secondary_offset);
     *secondary = *primary;
   }
 
@@ -171,6 +287,23 @@ Object* StubCache::ComputeLoadNormal(String* name, JSObject* receiver) {
 }
 
 
+Object* StubCache::ComputeLoadPolymorphic(String* name,
+                                          Map** maps,
+                                          Code** stubs,
+                                          int count) {
+  Code::Flags flags = Code::ComputeFlags(Code::LOAD_IC, POLYMORPHIC);
+  Code* cached = FindPolymorphicStub(flags, name, maps, stubs, count);
+  if (cached != NULL) return cached;
+  LoadStubCompiler compiler;
+  Object* code = compiler.CompileLoadPolymorphic(maps, stubs, count);
+  if (code->IsFailure()) return code;
+  Counters::polymorphic_ic_stubs.Increment();
+  LOG(CodeCreateEvent("LoadIC", Code::cast(code), name));
+  AddPolymorphicStub(flags, name, maps, stubs, count, Code::cast(code));
+  return code;
+}
+
+
 Object* StubCache::ComputeKeyedLoadField(String* name,
                                          JSObject* receiver,
                                          JSObject* holder,
@@ -331,6 +464,40 @@ Object* StubCache::ComputeKeyedLoadFunctionPrototype(String* name,
 }
 
 
+Object* StubCache::ComputeKeyedLoadFastElement(JSObject* receiver) {
+  String* name = Heap::empty_symbol();
+  Code::Flags flags =
+      Code::ComputeMonomorphicFlags(Code::KEYED_LOAD_IC, NORMAL);
+  Object* code = receiver->map()->FindInCodeCache(name, flags);
+  if (code->IsUndefined()) {
+    KeyedLoadStubCompiler compiler;
+    code = compiler.CompileLoadFastElement(receiver);
+    if (code->IsFailure()) return code;
+    LOG(CodeCreateEvent("KeyedLoadIC", Code::cast(code), name));
+    Object* result = receiver->map()->UpdateCodeCache(name, Code::cast(code));
+    if (result->IsFailure()) return result;
+  }
+  return code;
+}
+
+
+Object* StubCache::ComputeKeyedLoadPolymorphic(Map** maps,
+                                               Code** stubs,
+                                               int count) {
+  String* name = Heap::empty_symbol();
+  Code::Flags flags = Code::ComputeFlags(Code::KEYED_LOAD_IC, POLYMORPHIC);
+  Code* cached = FindPolymorphicStub(flags, name, maps, stubs, count);
+  if (cached != NULL) return cached;
+  KeyedLoadStubCompiler compiler;
+  Object* code = compiler.CompileLoadPolymorphic(maps, stubs, count);
+  if (code->IsFailure()) return code;
+  Counters::polymorphic_ic_stubs.Increment();
+  LOG(CodeCreateEvent("KeyedLoadIC", Code::cast(code), name));
+  AddPolymorphicStub(flags, name, maps, stubs, count, Code::cast(code));
+  return code;
+}
+
+
 Object* StubCache::ComputeStoreField(String* name,
                                      JSObject* receiver,
                                      int field_index,
@@ -385,6 +552,23 @@ Object* StubCache::ComputeStoreInterceptor(String* name,
 }
 
 
+Object* StubCache::ComputeStorePolymorphic(String* name,
+                                           Map** maps,
+                                           Code** stubs,
+                                           int count) {
+  Code::Flags flags = Code::ComputeFlags(Code::STORE_IC, POLYMORPHIC);
+  Code* cached = FindPolymorphicStub(flags, name, maps, stubs, count);
+  if (cached != NULL) return cached;
+  StoreStubCompiler compiler;
+  Object* code = compiler.CompileStorePolymorphic(maps, stubs, count);
+  if (code->IsFailure()) return code;
+  Counters::polymorphic_ic_stubs.Increment();
+  LOG(CodeCreateEvent("StoreIC", Code::cast(code), name));
+  AddPolymorphicStub(flags, name, maps, stubs, count, Code::cast(code));
+  return code;
+}
+
+
 Object* StubCache::ComputeKeyedStoreField(String* name, JSObject* receiver,
                                           int field_index, Map* transition) {
   PropertyType type = (transition == NULL) ? FIELD : MAP_TRANSITION;
@@ -402,6 +586,40 @@ Object* StubCache::ComputeKeyedStoreField(String* name, JSObject* receiver,
 }
 
 
+Object* StubCache::ComputeKeyedStoreFastElement(JSObject* receiver) {
+  String* name = Heap::empty_symbol();
+  Code::Flags flags =
+      Code::ComputeMonomorphicFlags(Code::KEYED_STORE_IC, NORMAL);
+  Object* code = receiver->map()->FindInCodeCache(name, flags);
+  if (code->IsUndefined()) {
+    KeyedStoreStubCompiler compiler;
+    code = compiler.CompileStoreFastElement(receiver);
+    if (code->IsFailure()) return code;
+    LOG(CodeCreateEvent("KeyedStoreIC", Code::cast(code), name));
+    Object* result = receiver->map()->UpdateCodeCache(name, Code::cast(code));
+    if (result->IsFailure()) return result;
+  }
+  return code;
+}
+
+
+Object* StubCache::ComputeKeyedStorePolymorphic(Map** maps,
+                                                Code** stubs,
+                                                int count) {
+  String* name = Heap::empty_symbol();
+  Code::Flags flags = Code::ComputeFlags(Code::KEYED_STORE_IC, POLYMORPHIC);
+  Code* cached = FindPolymorphicStub(flags, name, maps, stubs, count);
+  if (cached != NULL) return cached;
+  KeyedStoreStubCompiler compiler;
+  Object* code = compiler.CompileStorePolymorphic(maps, stubs, count);
+  if (code->IsFailure()) return code;
+  Counters::polymorphic_ic_stubs.Increment();
+  LOG(CodeCreateEvent("KeyedStoreIC", Code::cast(code), name));
+  AddPolymorphicStub(flags, name, maps, stubs, count, Code::cast(code));
+  return code;
+}
+
+
 Object* StubCache::ComputeCallConstant(int argc,
                                        String* name,
                                        Object* object,
@@ -517,6 +735,25 @@ Object* StubCache::ComputeCallNormal(int argc,
 }
 
 
+Object* StubCache::ComputeCallPolymorphic(int argc,
+                                          String* name,
+                                          Map** maps,
+                                          Code** stubs,
+                                          int count) {
+  Code::Flags flags =
+      Code::ComputeFlags(Code::CALL_IC, POLYMORPHIC, NORMAL, argc);
+  Code* cached = FindPolymorphicStub(flags, name, maps, stubs, count);
+  if (cached != NULL) return cached;
+  CallStubCompiler compiler(argc);
+  Object* code = compiler.CompileCallPolymorphic(maps, stubs, count);
+  if (code->IsFailure()) return code;
+  Counters::polymorphic_ic_stubs.Increment();
+  LOG(CodeCreateEvent("CallIC", Code::cast(code), name));
+  AddPolymorphicStub(flags, name, maps, stubs, count, Code::cast(code));
+  return code;
+}
+
+
 static Object* GetProbeValue(Code::Flags flags) {
   Dictionary* dictionary = Heap::non_monomorphic_cache();
   int entry = dictionary->FindNumberEntry(flags);
@@ -654,13 +891,22 @@ Object* StubCache::ComputeLazyCompile(int argc) {
 
 
 void StubCache::Clear() {
-  for (int i = 0; i < kPrimaryTableSize; i++) {
-    primary_[i].key = Heap::empty_string();
-    primary_[i].value = Builtins::builtin(Builtins::Illegal);
+  for (int i = 0; i < kPolymorphicCacheSize; i++) {
+    polymorphic_cache[i].value = NULL;
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
-    secondary_[j].key = Heap::empty_string();
-    secondary_[j].value = Builtins::builtin(Builtins::Illegal);
+  // Nothing to clear if a collection happens before the tables have
+  // been allocated.
+  if (primary_[kLoadGroup] == NULL) return;
+  int groups = separate_tables_ ? kGroupCount : 1;
+  for (int group = 0; group < groups; group++) {
+    for (int i = 0; i < primary_size_; i++) {
+      primary_[group][i].key = Heap::empty_string();
+      primary_[group][i].value = Builtins::builtin(Builtins::Illegal);
+    }
+    for (int j = 0; j < secondary_size_; j++) {
+      secondary_[group][j].key = Heap::empty_string();
+      secondary_[group][j].value = Builtins::builtin(Builtins::Illegal);
+    }
   }
 }
 
@@ -931,23 +1177,45 @@ Object* LoadStubCompiler::GetCode(PropertyType type) {
 }
 
 
+Object* LoadStubCompiler::GetPolymorphicCode() {
+  return GetCodeWithFlags(Code::ComputeFlags(Code::LOAD_IC, POLYMORPHIC));
+}
+
+
 Object* KeyedLoadStubCompiler::GetCode(PropertyType type) {
   return GetCodeWithFlags(Code::ComputeMonomorphicFlags(Code::KEYED_LOAD_IC,
                                                         type));
 }
 
 
+Object* KeyedLoadStubCompiler::GetPolymorphicCode() {
+  return GetCodeWithFlags(Code::ComputeFlags(Code::KEYED_LOAD_IC,
+                                             POLYMORPHIC));
+}
+
+
 Object* StoreStubCompiler::GetCode(PropertyType type) {
   return GetCodeWithFlags(Code::ComputeMonomorphicFlags(Code::STORE_IC, type));
 }
 
 
+Object* StoreStubCompiler::GetPolymorphicCode() {
+  return GetCodeWithFlags(Code::ComputeFlags(Code::STORE_IC, POLYMORPHIC));
+}
+
+
 Object* KeyedStoreStubCompiler::GetCode(PropertyType type) {
   return GetCodeWithFlags(Code::ComputeMonomorphicFlags(Code::KEYED_STORE_IC,
                                                         type));
 }
 
 
+Object* KeyedStoreStubCompiler::GetPolymorphicCode() {
+  return GetCodeWithFlags(Code::ComputeFlags(Code::KEYED_STORE_IC,
+                                             POLYMORPHIC));
+}
+
+
 Object* CallStubCompiler::GetCode(PropertyType type) {
   int argc = arguments_.immediate();
   Code::Flags flags = Code::ComputeMonomorphicFlags(Code::CALL_IC, type, argc);
@@ -955,4 +1223,12 @@ Object* CallStubCompiler::GetCode(PropertyType type) {
 }
 
 
+Object* CallStubCompiler::GetPolymorphicCode() {
+  int argc = arguments_.immediate();
+  Code::Flags flags =
+      Code::ComputeFlags(Code::CALL_IC, POLYMORPHIC, NORMAL, argc);
+  return GetCodeWithFlags(flags);
+}
+
+
 } }  // namespace v8::internal
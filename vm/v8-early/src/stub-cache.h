@@ -50,8 +50,17 @@ class StubCache : public AllStatic {
     Code* value;
   };
 
-
-  static void Initialize(bool create_heap_objects);
+  // Default number of entries in the primary and secondary tables.
+  static const int kDefaultPrimaryTableSize = 2048;
+  static const int kDefaultSecondaryTableSize = 512;
+
+  // Allocates the tables; the sizes must be powers of two. If
+  // separate_tables is true, load, store and call inline caches each
+  // probe their own pair of tables instead of sharing one.
+  static void Initialize(bool create_heap_objects,
+                         int primary_size = kDefaultPrimaryTableSize,
+                         int secondary_size = kDefaultSecondaryTableSize,
+                         bool separate_tables = false);
 
   // Computes the right stub matching. Inserts the result in the
   // cache before returning.  This might compile a stub if needed.
@@ -76,6 +85,14 @@ class StubCache : public AllStatic {
 
   static Object* ComputeLoadNormal(String* name, JSObject* receiver);
 
+  // Compiles a stub dispatching on the receiver map to the given
+  // monomorphic stubs. Polymorphic stubs are cached by their maps and
+  // stubs until the next mark-compact collection.
+  static Object* ComputeLoadPolymorphic(String* name,
+                                        Map** maps,
+                                        Code** stubs,
+                                        int count);
+
 
   // ---
 
@@ -110,6 +127,14 @@ class StubCache : public AllStatic {
   static Object* ComputeKeyedLoadFunctionPrototype(String* name,
                                                    JSFunction* receiver);
 
+  // Fast elements stubs are cached in the code cache of the receiver
+  // map under the empty symbol.
+  static Object* ComputeKeyedLoadFastElement(JSObject* receiver);
+
+  static Object* ComputeKeyedLoadPolymorphic(Map** maps,
+                                             Code** stubs,
+                                             int count);
+
   // ---
 
   static Object* ComputeStoreField(String* name,
@@ -123,6 +148,11 @@ class StubCache : public AllStatic {
 
   static Object* ComputeStoreInterceptor(String* name, JSObject* receiver);
 
+  static Object* ComputeStorePolymorphic(String* name,
+                                         Map** maps,
+                                         Code** stubs,
+                                         int count);
+
   // ---
 
   static Object* ComputeKeyedStoreField(String* name,
@@ -130,6 +160,12 @@ class StubCache : public AllStatic {
                                         int field_index,
                                         Map* transition = NULL);
 
+  static Object* ComputeKeyedStoreFastElement(JSObject* receiver);
+
+  static Object* ComputeKeyedStorePolymorphic(Map** maps,
+                                              Code** stubs,
+                                              int count);
+
   // ---
 
   static Object* ComputeCallField(int argc,
@@ -151,6 +187,12 @@ class StubCache : public AllStatic {
                                         Object* object,
                                         JSObject* holder);
 
+  static Object* ComputeCallPolymorphic(int argc,
+                                        String* name,
+                                        Map** maps,
+                                        Code** stubs,
+                                        int count);
+
   // ---
 
   static Object* ComputeCallInitialize(int argc);
@@ -189,12 +231,30 @@ class StubCache : public AllStatic {
     kSecondary
   };
 
+  // The tables are grouped by the kind of inline cache using them.
+  // Unless separate tables are used, all groups share the same tables.
+  enum Group {
+    kLoadGroup,
+    kStoreGroup,
+    kCallGroup,
+    kGroupCount
+  };
+
+  // Returns the table group probed for stubs with the given flags.
+  static Group GroupFor(Code::Flags flags);
+
  private:
   friend class SCTableReference;
-  static const int kPrimaryTableSize = 2048;
-  static const int kSecondaryTableSize = 512;
-  static Entry primary_[];
-  static Entry secondary_[];
+  static Entry* primary_[kGroupCount];
+  static Entry* secondary_[kGroupCount];
+  static int primary_size_;
+  static int secondary_size_;
+  static bool separate_tables_;
+
+  // Masks for turning hashes into table offsets. Generated code loads
+  // them from memory so that it does not depend on the table sizes.
+  static int primary_mask_;
+  static int secondary_mask_;
 
   // Computes the hashed offsets for primary and secondary caches.
   static int PrimaryOffset(String* name, Code::Flags flags, Map* map) {
@@ -203,13 +263,13 @@ class StubCache : public AllStatic {
     ASSERT(name_hash & String::kHashComputedMask);
     // Base the offset on a simple combination of name, flags, and map.
     uint32_t key = (reinterpret_cast<uint32_t>(map) + name_hash) ^ flags;
-    return key & ((kPrimaryTableSize - 1) << kHeapObjectTagSize);
+    return key & primary_mask_;
   }
 
   static int SecondaryOffset(String* name, Code::Flags flags, int seed) {
     // Use the seed from the primary cache in the secondary cache.
     uint32_t key = seed - reinterpret_cast<uint32_t>(name) + flags;
-    return key & ((kSecondaryTableSize - 1) << kHeapObjectTagSize);
+    return key & secondary_mask_;
   }
 
   // Compute the entry for a given offset in exactly the same way as
@@ -222,17 +282,37 @@ class StubCache : public AllStatic {
 };
 
 
+// References to the locations holding the table addresses and the
+// offset masks. The tables are allocated at StubCache::Initialize, so
+// generated code always goes through these locations.
 class SCTableReference {
  public:
-  static SCTableReference keyReference(StubCache::Table table) {
-    return SCTableReference(
-        reinterpret_cast<Address>(&first_entry(table)->key));
+  static SCTableReference tableReference(StubCache::Table table,
+                                         StubCache::Group group) {
+    switch (table) {
+      case StubCache::kPrimary:
+        return SCTableReference(
+            reinterpret_cast<Address>(&StubCache::primary_[group]));
+      case StubCache::kSecondary:
+        return SCTableReference(
+            reinterpret_cast<Address>(&StubCache::secondary_[group]));
+    }
+    UNREACHABLE();
+    return SCTableReference(NULL);
   }
 
 
-  static SCTableReference valueReference(StubCache::Table table) {
-    return SCTableReference(
-        reinterpret_cast<Address>(&first_entry(table)->value));
+  static SCTableReference maskReference(StubCache::Table table) {
+    switch (table) {
+      case StubCache::kPrimary:
+        return SCTableReference(
+            reinterpret_cast<Address>(&StubCache::primary_mask_));
+      case StubCache::kSecondary:
+        return SCTableReference(
+            reinterpret_cast<Address>(&StubCache::secondary_mask_));
+    }
+    UNREACHABLE();
+    return SCTableReference(NULL);
   }
 
   Address address() const { return address_; }
@@ -240,15 +320,6 @@ class SCTableReference {
  private:
   explicit SCTableReference(Address address) : address_(address) {}
 
-  static StubCache::Entry* first_entry(StubCache::Table table) {
-    switch (table) {
-      case StubCache::kPrimary: return StubCache::primary_;
-      case StubCache::kSecondary: return StubCache::secondary_;
-    }
-    UNREACHABLE();
-    return NULL;
-  }
-
   Address address_;
 };
 
@@ -281,6 +352,16 @@ class StubCompiler BASE_EMBEDDED {
     JSARRAY_HAS_FAST_ELEMENTS_CHECK
   };
 
+  // Builtin functions that call stubs inline for common argument types.
+  enum Intrinsic {
+    NO_INTRINSIC,
+    MATH_ABS,
+    MATH_FLOOR,
+    MATH_CEIL,
+    MATH_ROUND,
+    STRING_CHAR_CODE_AT
+  };
+
   StubCompiler() : masm_(NULL, 256) { }
 
   Object* CompileCallInitialize(Code::Flags flags);
@@ -382,9 +463,11 @@ class LoadStubCompiler: public StubCompiler {
   Object* CompileLoadInterceptor(JSObject* object,
                                  JSObject* holder,
                                  String* name);
+  Object* CompileLoadPolymorphic(Map** maps, Code** stubs, int count);
 
  private:
   Object* GetCode(PropertyType);
+  Object* GetPolymorphicCode();
 };
 
 
@@ -410,9 +493,12 @@ class KeyedLoadStubCompiler: public StubCompiler {
   Object* CompileLoadMediumStringLength(String* name);
   Object* CompileLoadLongStringLength(String* name);
   Object* CompileLoadFunctionPrototype(String* name);
+  Object* CompileLoadFastElement(JSObject* object);
+  Object* CompileLoadPolymorphic(Map** maps, Code** stubs, int count);
 
  private:
   Object* GetCode(PropertyType);
+  Object* GetPolymorphicCode();
 };
 
 
@@ -426,9 +512,11 @@ class StoreStubCompiler: public StubCompiler {
                                AccessorInfo* callbacks,
                                String* name);
   Object* CompileStoreInterceptor(JSObject* object, String* name);
+  Object* CompileStorePolymorphic(Map** maps, Code** stubs, int count);
 
  private:
   Object* GetCode(PropertyType type);
+  Object* GetPolymorphicCode();
 };
 
 
@@ -438,9 +526,12 @@ class KeyedStoreStubCompiler: public StubCompiler {
                             int index,
                             Map* transition,
                             String* name);
+  Object* CompileStoreFastElement(JSObject* object);
+  Object* CompileStorePolymorphic(Map** maps, Code** stubs, int count);
 
  private:
   Object* GetCode(PropertyType type);
+  Object* GetPolymorphicCode();
 };
 
 
@@ -456,6 +547,7 @@ class CallStubCompiler: public StubCompiler {
   Object* CompileCallInterceptor(Object* object,
                                  JSObject* holder,
                                  String* name);
+  Object* CompileCallPolymorphic(Map** maps, Code** stubs, int count);
 
  private:
   const ParameterCount arguments_;
@@ -463,6 +555,7 @@ class CallStubCompiler: public StubCompiler {
   const ParameterCount& arguments() { return arguments_; }
 
   Object* GetCode(PropertyType type);
+  Object* GetPolymorphicCode();
 };
 
 
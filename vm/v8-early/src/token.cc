@@ -54,45 +54,32 @@ int8_t Token::precedence_[NUM_TOKENS] = {
 #undef T
 
 
-// A perfect (0 collision) hash table of keyword token values.
-
-// larger N will reduce the number of collisions (power of 2 for fast %)
-const unsigned int N = 128;
-// make this small since we have <= 256 tokens
-static uint8_t Hashtable[N];
+// Keywords are bucketed by their first character and their length.
+// All keywords are lower case, so a lookup is two array indexings and
+// at most a couple of memcmps, and most identifiers are rejected
+// without touching any keyword string at all.
+
+// 'instanceof' is the longest keyword.
+static const int kMaxKeywordLength = 10;
+static const int kKeywordBucketSize = 4;
+// Make this small since we have <= 256 tokens.  Unused entries hold
+// IDENTIFIER, whose string is NULL.
+static uint8_t KeywordTable['z' - 'a' + 1][kMaxKeywordLength + 1]
+                           [kKeywordBucketSize];
 static bool IsInitialized = false;
 
 
-static unsigned int Hash(const char* s) {
-  // The following constants have been found using trial-and-error. If the
-  // keyword set changes, they may have to be recomputed (make them flags
-  // and play with the flag values). Increasing N is the simplest way to
-  // reduce the number of collisions.
-
-  // we must use at least 4 or more chars ('const' and 'continue' share
-  // 'con')
-  const unsigned int L = 5;
-  // smaller S tend to reduce the number of collisions
-  const unsigned int S = 4;
-  // make this a prime, or at least an odd number
-  const unsigned int M = 3;
-
-  unsigned int h = 0;
-  for (unsigned int i = 0; s[i] != '\0' && i < L; i++) {
-    h += (h << S) + s[i];
-  }
-  // unsigned int % by a power of 2 (otherwise this will not be a bit mask)
-  return h * M % N;
-}
-
-
-Token::Value Token::Lookup(const char* str) {
+Token::Value Token::Lookup(const char* str, int length) {
   ASSERT(IsInitialized);
-  Value k = static_cast<Value>(Hashtable[Hash(str)]);
-  const char* s = string_[k];
-  ASSERT(s != NULL || k == IDENTIFIER);
-  if (s == NULL || strcmp(s, str) == 0) {
-    return k;
+  if (length > kMaxKeywordLength) return IDENTIFIER;
+  unsigned int first = static_cast<unsigned char>(str[0]) - 'a';
+  if (first > static_cast<unsigned int>('z' - 'a')) return IDENTIFIER;
+  uint8_t* bucket = KeywordTable[first][length];
+  for (int i = 0; i < kKeywordBucketSize; i++) {
+    Value k = static_cast<Value>(bucket[i]);
+    if (k == IDENTIFIER) break;
+    // The first character is already known to match.
+    if (memcmp(string_[k] + 1, str + 1, length - 1) == 0) return k;
   }
   return IDENTIFIER;
 }
@@ -124,29 +111,38 @@ void Token::Initialize() {
   // defined by ECMA-262 standard.
   ASSERT(ARRAY_SIZE(keyword) == 25 + 3 + 3 + 1);  // +1 for ILLEGAL sentinel
 
-  // Initialize Hashtable.
-  ASSERT(NUM_TOKENS <= 256);  // Hashtable contains uint8_t elements
-  for (unsigned int i = 0; i < N; i++) {
-    Hashtable[i] = IDENTIFIER;
+  // Initialize KeywordTable.
+  ASSERT(NUM_TOKENS <= 256);  // KeywordTable contains uint8_t elements
+  for (int c = 0; c <= 'z' - 'a'; c++) {
+    for (int l = 0; l <= kMaxKeywordLength; l++) {
+      for (int i = 0; i < kKeywordBucketSize; i++) {
+        KeywordTable[c][l][i] = IDENTIFIER;
+      }
+    }
   }
 
-  // Insert all keywords into Hashtable.
-  int collisions = 0;
+  // Insert all keywords into KeywordTable.
   for (int i = 0; keyword[i] != ILLEGAL; i++) {
     Value k = keyword[i];
-    unsigned int h = Hash(string_[k]);
-    if (Hashtable[h] != IDENTIFIER) collisions++;
-    Hashtable[h] = k;
-  }
-
-  if (collisions > 0) {
-    PrintF("%d collisions in keyword hashtable\n", collisions);
-    FATAL("Fix keyword lookup!");
+    const char* s = string_[k];
+    int length = strlen(s);
+    if (s[0] < 'a' || s[0] > 'z' || length > kMaxKeywordLength) {
+      FATAL("Fix keyword lookup!");
+    }
+    uint8_t* bucket = KeywordTable[s[0] - 'a'][length];
+    int j = 0;
+    while (j < kKeywordBucketSize && bucket[j] != IDENTIFIER) j++;
+    if (j == kKeywordBucketSize) {
+      PrintF("too many keywords of length %d starting with '%c'\n",
+             length, s[0]);
+      FATAL("Fix keyword lookup!");
+    }
+    bucket[j] = k;
   }
 
   IsInitialized = true;
 
-  // Verify hash table.
+  // Verify keyword table.
 #define T(name, string, precedence) \
   ASSERT(IsNull(string) || Lookup(string) == IDENTIFIER);
 
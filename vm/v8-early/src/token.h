@@ -262,7 +262,13 @@ class Token {
   // Returns the keyword value if str is a keyword;
   // returns IDENTIFIER otherwise. The class must
   // have been initialized.
-  static Value Lookup(const char* str);
+  static Value Lookup(const char* str) {
+    return Lookup(str, strlen(str));
+  }
+
+  // Same as above for the first length characters of str, which need
+  // not be null terminated.
+  static Value Lookup(const char* str, int length);
 
   // Must be called once to initialize the class.
   // Multiple calls are ignored.
@@ -861,6 +861,15 @@ Object* Top::LookupSpecialFunction(JSObject* receiver,
 }
 
 
+Object* Top::LookupIntrinsicFunction(JSFunction* function) {
+  FixedArray* table = context()->global_context()->intrinsic_function_table();
+  for (int index = 0; index < table->length(); index += 2) {
+    if (function == table->get(index)) return table->get(index+1);
+  }
+  return Heap::undefined_value();
+}
+
+
 char* Top::ArchiveThread(char* to) {
   memcpy(to, reinterpret_cast<char*>(&thread_local_), sizeof(thread_local_));
   InitializeThreadLocal();
@@ -257,6 +257,10 @@ class Top {
                                        JSObject* prototype,
                                        JSFunction* value);
 
+  // Returns the intrinsic id (as a smi) of a builtin function that call
+  // stubs may inline, or undefined if there is none.
+  static Object* LookupIntrinsicFunction(JSFunction* function);
+
   static void RegisterTryCatchHandler(v8::TryCatch* that);
   static void UnregisterTryCatchHandler(v8::TryCatch* that);
 
@@ -70,6 +70,10 @@ namespace v8 { namespace internal {
   SC(call_premonomorphic_stubs, V8.CallPreMonomorphicStubs)      \
   SC(call_normal_stubs, V8.CallNormalStubs)                      \
   SC(call_megamorphic_stubs, V8.CallMegamorphicStubs)            \
+  SC(polymorphic_ic_stubs, V8.PolymorphicICStubs)                \
+  SC(stub_cache_primary_hits, V8.StubCachePrimaryHits)           \
+  SC(stub_cache_secondary_hits, V8.StubCacheSecondaryHits)       \
+  SC(stub_cache_misses, V8.StubCacheMisses)                      \
   SC(arguments_adaptors, V8.ArgumentsAdaptors)                   \
   /* Amount of evaled source code. */                            \
   SC(total_eval_size, V8.TotalEvalSize)                          \
@@ -80,7 +84,10 @@ namespace v8 { namespace internal {
   /* Amount of source code skipped over using preparsing. */     \
   SC(total_preparse_skipped, V8.TotalPreparseSkipped)            \
   /* Amount of compiled source code. */                          \
-  SC(total_compile_size, V8.TotalCompileSize)
+  SC(total_compile_size, V8.TotalCompileSize)                    \
+  /* Compilation cache lookups for scripts and evals. */         \
+  SC(compilation_cache_hits, V8.CompilationCacheHits)            \
+  SC(compilation_cache_misses, V8.CompilationCacheMisses)
 
 
 #define STATS_COUNTER_LIST_2(SC)                                    \
@@ -97,6 +104,9 @@ namespace v8 { namespace internal {
      V8.GCCompactorCausedByOldspaceExhaustion)                      \
   SC(gc_compactor_caused_by_weak_handles,                           \
      V8.GCCompactorCausedByWeakHandles)                             \
+  /* Pretenuring based on allocation site feedback. */              \
+  SC(pretenured_sites, V8.PretenuredSites)                          \
+  SC(pretenured_allocations, V8.PretenuredAllocations)              \
   /* How is the generic keyed-load stub used? */                    \
   SC(keyed_load_generic_smi, V8.KeyedLoadGenericSmi)                \
   SC(keyed_load_generic_symbol, V8.KeyedLoadGenericSymbol)          \
@@ -109,7 +119,9 @@ namespace v8 { namespace internal {
   SC(keyed_load_field, V8.KeyedLoadField)                           \
   SC(keyed_load_callback, V8.KeyedLoadCallback)                     \
   SC(keyed_load_interceptor, V8.KeyedLoadInterceptor)               \
+  SC(keyed_load_fast_element, V8.KeyedLoadFastElement)              \
   SC(keyed_store_field, V8.KeyedStoreField)                         \
+  SC(keyed_store_fast_element, V8.KeyedStoreFastElement)            \
   SC(for_in, V8.ForIn)                                              \
   SC(enum_cache_hits, V8.EnumCacheHits)                             \
   SC(enum_cache_misses, V8.EnumCacheMisses)                         \
@@ -29,6 +29,7 @@
 
 #include "bootstrapper.h"
 #include "debug.h"
+#include "ic-inl.h"
 #include "serialize.h"
 #include "stub-cache.h"
 
@@ -36,6 +37,12 @@ namespace v8 { namespace internal {
 
 DEFINE_bool(preemption, false,
             "activate a 100ms timer that switches between V8 threads");
+DEFINE_int(stub_cache_primary_size, StubCache::kDefaultPrimaryTableSize,
+           "number of entries in the primary stub cache table");
+DEFINE_int(stub_cache_secondary_size, StubCache::kDefaultSecondaryTableSize,
+           "number of entries in the secondary stub cache table");
+DEFINE_bool(separate_stub_caches, false,
+            "use separate stub cache tables for loads, stores and calls");
 
 bool V8::has_been_setup_ = false;
 bool V8::has_been_disposed_ = false;
@@ -78,7 +85,10 @@ bool V8::Initialize(Deserializer *des) {
   }
 
   Debug::Setup(create_heap_objects);
-  StubCache::Initialize(create_heap_objects);
+  StubCache::Initialize(create_heap_objects,
+                        NextPowerOf2(Max(FLAG_stub_cache_primary_size, 1)),
+                        NextPowerOf2(Max(FLAG_stub_cache_secondary_size, 1)),
+                        FLAG_separate_stub_caches);
 
   // If we are deserializing, read the state into the now-empty heap.
   if (des != NULL) {
@@ -99,6 +109,11 @@ void V8::TearDown() {
     v8::Locker::StopPreemption();
   }
 
+  if (FLAG_ic_stats) {
+    ICStats::Print(stdout);
+    ICStats::Reset();
+  }
+
   Builtins::TearDown();
   Bootstrapper::TearDown();
 
@@ -0,0 +1,144 @@
+# Copyright 2006-2008 Google Inc. All Rights Reserved.
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above
+#       copyright notice, this list of conditions and the following
+#       disclaimer in the documentation and/or other materials provided
+#       with the distribution.
+#     * Neither the name of Google Inc. nor the names of its
+#       contributors may be used to endorse or promote products derived
+#       from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Runs the JavaScript benchmarks in the benchmarks directory with the
+# shell and reports the time each one takes.  The results can be saved
+# as JSON and used as the baseline for a later run, which then reports
+# the benchmarks that got slower than the threshold.
+#
+# Usage:
+#   tools/run-benchmarks.py --shell=debug/shell --output=base.json
+#   tools/run-benchmarks.py --shell=debug/shell --baseline=base.json
+
+import glob
+import json
+import optparse
+import os
+import subprocess
+import sys
+
+
+def BuildOptions():
+  result = optparse.OptionParser()
+  result.add_option("--shell", help="the shell binary to run", default=None)
+  result.add_option("--iterations", help="timed runs of each benchmark",
+                    default=10, type="int")
+  result.add_option("--warmup", help="untimed runs of each benchmark",
+                    default=3, type="int")
+  result.add_option("--output", help="file to save the results to",
+                    default=None)
+  result.add_option("--baseline", help="results to compare against",
+                    default=None)
+  result.add_option("--threshold", help="slowdown in percent reported as a "
+                    "regression", default=5.0, type="float")
+  return result
+
+
+def RunShell(options, files):
+  command = [options.shell,
+             "--iterations=%d" % options.iterations,
+             "--warmup=%d" % options.warmup,
+             "--json"] + files
+  process = subprocess.Popen(command, stdout=subprocess.PIPE)
+  output = process.communicate()[0].decode("utf-8")
+  if process.returncode != 0:
+    sys.stderr.write(output)
+    sys.stderr.write("Benchmark run failed: %s\n" % " ".join(command))
+    return None
+  # Anything printed by the benchmarks themselves precedes the results.
+  return json.loads(output[output.index("{"):])
+
+
+def Name(result):
+  return os.path.splitext(os.path.basename(result["file"]))[0]
+
+
+def PrintResults(results):
+  print("%-12s %12s %12s %12s" % ("benchmark", "mean (ms)", "min (ms)",
+                                  "gc (ms)"))
+  for result in results["results"]:
+    total = result["total_ms"]
+    print("%-12s %12.3f %12.3f %12.3f" % (Name(result), total["mean"],
+                                          total["min"], result["gc_ms"]))
+
+
+def Compare(results, baseline, threshold):
+  """Prints the change in mean time of each benchmark relative to the
+  baseline and returns the number of regressions."""
+  old = {}
+  for result in baseline["results"]:
+    old[Name(result)] = result["total_ms"]["mean"]
+  regressions = 0
+  print("")
+  print("%-12s %12s %12s %9s" % ("benchmark", "base (ms)", "now (ms)",
+                                 "change"))
+  for result in results["results"]:
+    name = Name(result)
+    now = result["total_ms"]["mean"]
+    if name not in old:
+      print("%-12s %12s %12.3f %9s" % (name, "-", now, "new"))
+      continue
+    change = 0.0
+    if old[name] > 0:
+      change = (now - old[name]) * 100.0 / old[name]
+    marker = ""
+    if change > threshold:
+      marker = "  REGRESSION"
+      regressions += 1
+    print("%-12s %12.3f %12.3f %+8.1f%%%s" % (name, old[name], now, change,
+                                              marker))
+  return regressions
+
+
+def Main():
+  parser = BuildOptions()
+  (options, args) = parser.parse_args()
+  if options.shell is None:
+    parser.error("--shell is required")
+  files = args
+  if not files:
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    files = sorted(glob.glob(os.path.join(root, "benchmarks", "*.js")))
+  results = RunShell(options, files)
+  if results is None:
+    return 1
+  PrintResults(results)
+  if options.output:
+    output = open(options.output, "w")
+    json.dump(results, output, indent=2, sort_keys=True)
+    output.close()
+  if options.baseline:
+    baseline_file = open(options.baseline)
+    baseline = json.load(baseline_file)
+    baseline_file.close()
+    if Compare(results, baseline, options.threshold) > 0:
+      return 1
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(Main())